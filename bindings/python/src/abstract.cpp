@@ -32,6 +32,13 @@ void init_abstract(nb::module_& _Module) {
         .def("apply_relative_offset", &InProcess::applyRelativeOffset,
              "Apply a relative offset to a base pointer.", nb::arg("offset"));
 
+    nb::enum_<umbrella::Architecture>(_Module, "ARCHITECTURE")
+        .value("UNKNOWN", umbrella::Architecture::UNKNOWN)
+        .value("ARM64", umbrella::Architecture::ARM64)
+        .value("ARM64E", umbrella::Architecture::ARM64E)
+        .value("X86_64", umbrella::Architecture::X86_64)
+        .export_values();
+
     // ABIBase will be private within the C++ API
     nb::class_<umbrella::ABIBase>(_Module, "ABIBase")
         .def_prop_ro("image_base", &umbrella::ABIBase::imagebase);
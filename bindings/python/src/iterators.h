@@ -41,8 +41,10 @@ void iterator_(nb::handle& _Module, const char* _Name) {
 
         .def("__len__", [](T& self) { return self.size(); })
 
+        // the copy may refer to data owned by whatever self keeps alive
         .def(
-            "__iter__", [](const T& self) { return std::begin(self); }, nb::rv_policy::move)
+            "__iter__", [](const T& self) { return std::begin(self); }, nb::rv_policy::move,
+            nb::keep_alive<0, 1>())
 
         .def("__next__", [](T& self) -> typename T::reference {
             if (self == std::end(self)) {
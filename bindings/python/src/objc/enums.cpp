@@ -55,6 +55,12 @@ void init_enums(nb::module_& _Module){
 #undef METHOD_TYPE
         .export_values();
 
+    nb::enum_<umbrella::objc::TypeError>(_Module, "TYPE_ERROR")
+        .value("NONE", umbrella::objc::TypeError::NONE)
+        .value("UNEXPECTED_END", umbrella::objc::TypeError::UNEXPECTED_END)
+        .value("TOO_DEEP", umbrella::objc::TypeError::TOO_DEEP)
+        .value("NUMBER_TOO_LARGE", umbrella::objc::TypeError::NUMBER_TOO_LARGE);
+
 }
 
 PY_OBJC_NS_END
\ No newline at end of file
@@ -58,9 +58,42 @@ void init(nb::module_& _Module) {
     create<umbrella::objc::Protocol>(_objc);
     create<umbrella::objc::Class>(_objc);
     create<umbrella::objc::Category>(_objc);
+    create<umbrella::objc::EffectiveClass>(_objc);
     create<umbrella::objc::ABIObjectiveC>(_objc);
 
-    _objc.def("parse", &umbrella::objc::parseObjC, "file_name"_a);
+    _objc.def("parse",
+              nb::overload_cast<const std::string&, const umbrella::objc::ParseOptions&>(
+                  &umbrella::objc::parseObjC),
+              "file_name"_a, "options"_a = umbrella::objc::ParseOptions());
+    _objc.def("parse",
+              nb::overload_cast<const std::string&, umbrella::Architecture,
+                                const umbrella::objc::ParseOptions&>(&umbrella::objc::parseObjC),
+              "file_name"_a, "arch"_a, "options"_a = umbrella::objc::ParseOptions());
+
+    _objc.def(
+        "parse_slices",
+        [](const std::string& fileName, const umbrella::objc::ParseOptions& options,
+           bool concurrent) {
+            nb::list result;
+            for (umbrella::objc::Slice& slice :
+                 umbrella::objc::parseObjCSlices(fileName, options, concurrent)) {
+                result.append(nb::make_tuple(slice.architecture, std::move(slice.abi)));
+            }
+            return result;
+        },
+        "file_name"_a, "options"_a = umbrella::objc::ParseOptions(), "concurrent"_a = true,
+        R"doc(
+        Parses all supported slices of a (fat) binary.
+
+        :param file_name: the file to parse
+        :type file_name: str
+        :param options: options used for every slice
+        :type options: ParseOptions
+        :param concurrent: whether slices are parsed on multiple threads
+        :type concurrent: bool
+        :return: a list of (architecture, ABI) tuples in file order
+        :rtype: List[Tuple[umbrellacxx.ARCHITECTURE, ABIObjectiveC]]
+    )doc");
 }
 
 PY_OBJC_NS_END
\ No newline at end of file
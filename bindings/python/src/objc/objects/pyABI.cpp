@@ -16,12 +16,17 @@
 #include "objc/pyObjC.h"
 
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 #include <nanobind/stl/vector.h>
 
 #include <sstream>
 #include <string>
 
 #include <umbrella/objc/ABI.h>
+#include <umbrella/objc/ConformanceIndex.h>
+#include <umbrella/objc/HierarchyIndex.h>
+#include <umbrella/objc/Method.h>
+#include <umbrella/objc/MethodTable.h>
 
 #include "iterators.h"
 #include "attributes.h"
@@ -29,9 +34,126 @@
 PY_OBJC_NS_BEGIN
 
 using ABIObjectiveC = umbrella::objc::ABIObjectiveC;
+using ParseOptions = umbrella::objc::ParseOptions;
+using MethodTable = umbrella::objc::MethodTable;
+using HierarchyIndex = umbrella::objc::HierarchyIndex;
+using ConformanceIndex = umbrella::objc::ConformanceIndex;
+using Class = umbrella::objc::Class;
 
 template <>
 void create<ABIObjectiveC>(nb::module_& _Module) {
+    nb::class_<ParseOptions>(_Module, "ParseOptions")
+        .def(nb::init<>())
+        .def_rw("max_depth", &ParseOptions::maxDepth, R"doc(
+        Maximum number of superclass/metaclass (or adopted protocol) links
+        followed from a single object.
+      )doc")
+        .def_rw("threads", &ParseOptions::threads, R"doc(
+        Number of threads used to parse classes, categories and protocols
+        (0 selects the number of hardware threads).
+      )doc")
+        .def_rw("lazy", &ParseOptions::lazy, R"doc(
+        Defer decoding of methods, ivars, properties and protocols until
+        they are first accessed.
+      )doc")
+        .def_rw("zero_copy", &ParseOptions::zeroCopy, R"doc(
+        Reference names, selectors and type encodings directly in the mapped
+        binary instead of copying them.
+      )doc")
+        .def_rw("mapped", &ParseOptions::mapped, R"doc(
+        Memory-map the file and read only the Mach-O header, segments and
+        sections instead of running the full LIEF parser (``parse`` only).
+      )doc")
+        .def_rw("shared_strings", &ParseOptions::sharedStrings, R"doc(
+        Intern strings in a process-wide pool shared by all parsed images.
+      )doc");
+
+    nb::class_<MethodTable> objc_MethodTable(_Module, "MethodTable", nb::is_final());
+
+    nb::enum_<MethodTable::OwnerKind>(objc_MethodTable, "OWNER_KIND")
+        .value("CLASS", MethodTable::CLASS)
+        .value("CATEGORY", MethodTable::CATEGORY)
+        .value("PROTOCOL", MethodTable::PROTOCOL);
+
+    nb::enum_<MethodTable::Flags>(objc_MethodTable, "FLAGS", nb::is_arithmetic())
+        .value("CLASS_METHOD", MethodTable::CLASS_METHOD)
+        .value("SMALL_METHOD", MethodTable::SMALL_METHOD)
+        .value("OPTIONAL", MethodTable::OPTIONAL);
+
+    nb::class_<MethodTable::Range>(objc_MethodTable, "Range")
+        .def_ro("begin", &MethodTable::Range::begin)
+        .def_ro("end", &MethodTable::Range::end)
+        .def("__len__", &MethodTable::Range::size);
+
+    objc_MethodTable.def("__len__", &MethodTable::size)
+        .def_prop_ro("owner_kinds", &MethodTable::getOwnerKinds)
+        .def_prop_ro("owners", &MethodTable::getOwners)
+        .def_prop_ro("selectors", &MethodTable::getSelectors)
+        .def_prop_ro("signatures", &MethodTable::getSignatures)
+        .def_prop_ro("implementations", &MethodTable::getImplementations)
+        .def_prop_ro("flags", &MethodTable::getFlags)
+        .def("method", [](const MethodTable& _Table, size_t _Index) {
+            if (_Index >= _Table.size()) {
+                throw nb::index_error();
+            }
+            return _Table.getMethods()[_Index];
+        }, nb::rv_policy::reference_internal)
+        .def("of_class", &MethodTable::ofClass)
+        .def("of_category", &MethodTable::ofCategory)
+        .def("of_protocol", &MethodTable::ofProtocol);
+
+    nb::class_<HierarchyIndex> objc_HierarchyIndex(_Module, "HierarchyIndex", nb::is_final());
+
+    nb::class_<HierarchyIndex::Range>(objc_HierarchyIndex, "Range")
+        .def_ro("begin", &HierarchyIndex::Range::begin)
+        .def_ro("end", &HierarchyIndex::Range::end)
+        .def("__len__", &HierarchyIndex::Range::size);
+
+    objc_HierarchyIndex.def_ro_static("NONE", &HierarchyIndex::NONE)
+        .def("__len__", &HierarchyIndex::size)
+        .def("find", &HierarchyIndex::find)
+        .def("is_subclass_of",
+             nb::overload_cast<uint32_t, uint32_t>(&HierarchyIndex::isSubclassOf, nb::const_))
+        .def("is_subclass_of",
+             nb::overload_cast<const Class*, const Class*>(&HierarchyIndex::isSubclassOf, nb::const_))
+        .def("subclasses_of", &HierarchyIndex::subclassesOf)
+        .def("children_of", &HierarchyIndex::childrenOf)
+        .def_prop_ro("children", &HierarchyIndex::getChildren)
+        .def("class_", [](const HierarchyIndex& _Index, uint32_t _Node) {
+            if (_Node >= _Index.size()) {
+                throw nb::index_error();
+            }
+            return _Index.getClass(_Node);
+        }, nb::rv_policy::reference_internal)
+        .def("parent", [](const HierarchyIndex& _Index, uint32_t _Node) {
+            if (_Node >= _Index.size()) {
+                throw nb::index_error();
+            }
+            return _Index.getParent(_Node);
+        })
+        .def("depth", [](const HierarchyIndex& _Index, uint32_t _Node) {
+            if (_Node >= _Index.size()) {
+                throw nb::index_error();
+            }
+            return _Index.getDepth(_Node);
+        });
+
+    nb::class_<ConformanceIndex>(_Module, "ConformanceIndex", nb::is_final())
+        .def_ro_static("NONE", &ConformanceIndex::NONE)
+        .def("__len__", &ConformanceIndex::size)
+        .def("find", &ConformanceIndex::find)
+        .def("conforms_to", &ConformanceIndex::conformsTo)
+        .def("protocol_conforms_to", &ConformanceIndex::protocolConformsTo)
+        .def("conforming_classes", &ConformanceIndex::conformingClasses)
+        .def("categories_of", &ConformanceIndex::categoriesOf)
+        .def_prop_ro("categories", &ConformanceIndex::getCategories)
+        .def("protocol", [](const ConformanceIndex& _Index, uint32_t _Id) {
+            if (_Id >= _Index.size()) {
+                throw nb::index_error();
+            }
+            return _Index.getProtocol(_Id);
+        }, nb::rv_policy::reference_internal);
+
     nb::class_<ABIObjectiveC, umbrella::ABIBase> objc_ABI(_Module, "ABIObjectiveC", nb::is_final());
 
     iterator_<ABIObjectiveC::it_classes>(objc_ABI, "it_classes");
@@ -41,9 +163,20 @@ void create<ABIObjectiveC>(nb::module_& _Module) {
     objc_ABI.def_prop_ro("classes", &ABIObjectiveC::getClasses, nb::rv_policy::move)
         .def_prop_ro("protocols", &ABIObjectiveC::getProtocols, nb::rv_policy::move)
         .def_prop_ro("categories", &ABIObjectiveC::getCategories, nb::rv_policy::move)
+        .def_prop_ro("options", &ABIObjectiveC::getOptions, nb::rv_policy::reference_internal)
         .def_prop_ro("get_class", &ABIObjectiveC::getClass, nb::rv_policy::reference_internal)
         .def_prop_ro("get_category", &ABIObjectiveC::getCategory, nb::rv_policy::reference_internal)
         .def_prop_ro("get_protocol", &ABIObjectiveC::getProtocol, nb::rv_policy::reference_internal)
+        .def_prop_ro("method_table", &ABIObjectiveC::getMethodTable, nb::rv_policy::reference_internal)
+        .def("find_selector", &ABIObjectiveC::findSelector)
+        .def("method_at", &ABIObjectiveC::methodAt, nb::rv_policy::reference_internal)
+        .def_prop_ro("hierarchy", &ABIObjectiveC::getHierarchyIndex, nb::rv_policy::reference_internal)
+        .def_prop_ro("conformance", &ABIObjectiveC::getConformanceIndex, nb::rv_policy::reference_internal)
+        .def("conforms_to", &ABIObjectiveC::conformsTo)
+        .def("effective_class", &ABIObjectiveC::getEffectiveClass, nb::rv_policy::reference_internal)
+        .def("string", [](const ABIObjectiveC& _ABI, umbrella::StringPool::Handle _Handle) {
+            return _ABI.getStringPool().get(_Handle);
+        })
         PY_ATTR___STR__(ABIObjectiveC,
             stream << "<ABIObjectiveC ";
             stream << "classes=" << _Value.getClassCount() << ", ";
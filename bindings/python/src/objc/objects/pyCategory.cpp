@@ -19,6 +19,7 @@
 #include <pybind11/stl.h>
 #else
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 #endif
 
 #include <umbrella/objc/Category.h>
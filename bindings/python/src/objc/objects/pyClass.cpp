@@ -16,6 +16,7 @@
 #include "objc/pyObjC.h"
 
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 #include <umbrella/objc/Class.h>
 
 #include "iterators.h"
@@ -35,6 +36,7 @@ void create<Class>(nb::module_& _Module) {
         .def_prop_ro("meta_class", &Class::getMetaClass, nb::rv_policy::reference_internal)
         .def("has_super_class", &Class::hasSuperClass)
         .def("has_meta_class", &Class::hasMetaClass)
+        .def("is_imported", &Class::isImported)
         .def("get_decl", &Class::getDeclaration);
 
     iterator_<Class::it_ivars>(objc_Class, "it_ivars");
@@ -0,0 +1,43 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "objc/pyObjC.h"
+
+#include <umbrella/objc/EffectiveClass.h>
+
+#include "iterators.h"
+#include "attributes.h"
+
+PY_OBJC_NS_BEGIN
+
+using EffectiveClass = umbrella::objc::EffectiveClass;
+
+template <>
+void create<EffectiveClass>(nb::module_& _Module) {
+    nb::class_<EffectiveClass> objc_EffectiveClass(_Module, "EffectiveClass", nb::is_final());
+
+    iterator_<EffectiveClass::it_categories>(objc_EffectiveClass, "it_categories");
+    iterator_<EffectiveClass::it_protocols>(objc_EffectiveClass, "it_protocols");
+
+    objc_EffectiveClass
+        .def_prop_ro("cls", &EffectiveClass::getClass, nb::rv_policy::reference_internal)
+        .def_prop_ro("categories", &EffectiveClass::getCategories, nb::rv_policy::move)
+        .def_prop_ro("methods", &EffectiveClass::getMethods, nb::rv_policy::move)
+        .def_prop_ro("class_methods", &EffectiveClass::getClassMethods, nb::rv_policy::move)
+        .def_prop_ro("properties", &EffectiveClass::getProperties, nb::rv_policy::move)
+        .def_prop_ro("protocols", &EffectiveClass::getProtocols, nb::rv_policy::move);
+}
+
+PY_OBJC_NS_END
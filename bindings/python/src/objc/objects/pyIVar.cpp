@@ -16,6 +16,7 @@
 #include "objc/pyObjC.h"
 
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 #include <umbrella/objc/IVar.h>
 
 #include "attributes.h"
@@ -28,12 +29,12 @@ template <>
 void create<IVar>(nb::module_& _Module) {
   nb::class_<IVar, umbrella::InProcess>(_Module, "IVar", nb::is_final())
     .def_prop_ro("name", [](const IVar& ivar) {
-      const std::string& fullname = ivar.getName();
+      const std::string_view fullname = ivar.getName();
       return nb::bytes(fullname.data(), fullname.size());
     })
     .def_prop_ro("mangled_type_name",
     [](const IVar& ivar) {
-      const std::string& fullname = ivar.getMangledTypeName();
+      const std::string_view fullname = ivar.getMangledTypeName();
       return nb::bytes(fullname.data(), fullname.size());
     })
     .def_prop_ro("alignment", &IVar::getAlignment)
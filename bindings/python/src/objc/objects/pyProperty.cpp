@@ -16,6 +16,7 @@
 #include "objc/pyObjC.h"
 
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 #include <umbrella/objc/Property.h>
 
 #include "attributes.h"
@@ -20,11 +20,13 @@
 #else
 #include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 #include <nanobind/stl/vector.h>
 #endif
 
 #include <memory>
 #include <sstream>
+#include <umbrella/objc/TypeCache.h>
 #include <umbrella/objc/TypeEncoding.h>
 
 #include "iterators.h"
@@ -34,6 +36,7 @@
 PY_OBJC_NS_BEGIN
 
 using TypeNode = umbrella::objc::TypeNode;
+using TypeCache = umbrella::objc::TypeCache;
 
 template <>
 void create<TypeNode>(nb::module_& _Module) {
@@ -42,19 +45,59 @@ void create<TypeNode>(nb::module_& _Module) {
 
     cls_TypeNode.def("get_type", &TypeNode::getType)
         .def("get_attr_type", &TypeNode::getAttributeType)
-        .def_prop_ro("children", &TypeNode::getChildren, nb::rv_policy::move)
+        // children point into the tree owned by the root node
+        .def_prop_ro("children", &TypeNode::getChildren, nb::rv_policy::move,
+                     nb::keep_alive<0, 1>())
         .def_ro("type", &TypeNode::type)
         .def_ro("size", &TypeNode::size)
         .def_ro("alignment", &TypeNode::alignment)
         .def_ro("stack_size", &TypeNode::stack_size)
-        .def_ro("attributes", &TypeNode::attributes)
+        .def_prop_ro("attributes", &TypeNode::getAttributes)
         .def_ro("name", &TypeNode::name)
-        .def_ro("parent", &TypeNode::parent)
+        .def_prop_ro("parent", &TypeNode::getParent, nb::rv_policy::reference_internal)
         .def("__str__", [](const TypeNode& Self) {
             std::ostringstream stream;
             stream << "TypeNode[type=" << Self.type << "]";
             return stream.str();
         });
+
+    nb::class_<umbrella::objc::TypeResult>(_Module, "TypeResult")
+        .def_ro("node", &umbrella::objc::TypeResult::node)
+        .def_ro("error", &umbrella::objc::TypeResult::error)
+        .def_ro("offset", &umbrella::objc::TypeResult::offset)
+        .def("ok", &umbrella::objc::TypeResult::ok)
+        .def("__str__", [](const umbrella::objc::TypeResult& Self) {
+            std::stringstream stream;
+            stream << "TypeResult[" << umbrella::objc::describe(Self.error)
+                   << ", offset=" << Self.offset << "]";
+            return stream.str();
+        });
+
+    _Module.def("parse_encoding", &umbrella::objc::parseEncoding, R"doc(
+        Parses a type encoding without raising on malformed input.
+
+        Example:
+        >>> umbrella.objc.parse_encoding("{CGPoint=dd").error
+        <TYPE_ERROR.UNEXPECTED_END: 1>
+      )doc");
+
+    auto cls_TypeCache = nb::class_<TypeCache>(_Module, "TypeCache");
+    nb::class_<TypeCache::Stats>(cls_TypeCache, "Stats")
+        .def_ro("hits", &TypeCache::Stats::hits)
+        .def_ro("misses", &TypeCache::Stats::misses)
+        .def_ro("size", &TypeCache::Stats::size)
+        .def_ro("capacity", &TypeCache::Stats::capacity);
+
+    cls_TypeCache.def(nb::init<size_t>(), nb::arg("capacity") = TypeCache::DEFAULT_CAPACITY)
+        .def("typedesc", &TypeCache::typedesc)
+        .def("decode", &TypeCache::decode)
+        .def("signature", &TypeCache::signature)
+        .def("clear", &TypeCache::clear)
+        .def_prop_ro("stats", &TypeCache::getStats)
+        .def_static("get_global", &TypeCache::global, nb::rv_policy::reference, R"doc(
+        Returns the process-wide cache used to decode methods, ivars and
+        properties.
+      )doc");
 }
 
 PY_OBJC_NS_END
\ No newline at end of file
@@ -11,7 +11,7 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License.
-from typing import TypeVar, Iterable
+from typing import ClassVar, TypeVar, Iterable
 
 from . import objc
 
@@ -20,6 +20,15 @@ __commit__: str = ...
 __tag__: str = ...
 __full_version__: str = ...
 
+class ARCHITECTURE:
+    UNKNOWN: ClassVar[ARCHITECTURE] = ...
+    ARM64: ClassVar[ARCHITECTURE] = ...
+    ARM64E: ClassVar[ARCHITECTURE] = ...
+    X86_64: ClassVar[ARCHITECTURE] = ...
+    __name__: str = ...
+    def __init__(self, *args, **kwargs) -> None: ...
+    def __int__(self) -> int: ...
+
 class InProcess:
     def __init__(self, __address: int) -> None: ...
     @property
@@ -11,7 +11,7 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License.
-from typing import final, ClassVar, List, Optional
+from typing import final, overload, ClassVar, List, Optional, Tuple
 
 import umbrellacxx
 
@@ -76,6 +76,15 @@ class METHOD_TYPE:
     def __init__(self, *args, **kwargs) -> None: ...
     def __int__(self) -> int: ...
 
+class TYPE_ERROR:
+    NONE: ClassVar[NONE] = ...
+    UNEXPECTED_END: ClassVar[UNEXPECTED_END] = ...
+    TOO_DEEP: ClassVar[TOO_DEEP] = ...
+    NUMBER_TOO_LARGE: ClassVar[NUMBER_TOO_LARGE] = ...
+    __name__: str = ...
+    def __init__(self, *args, **kwargs) -> None: ...
+    def __int__(self) -> int: ...
+
 class TypeNode:
     class it_children(umbrellacxx.it[TypeNode]):
         pass
@@ -99,7 +108,37 @@ class TypeNode:
     @property
     def parent(self) -> Optional[TypeNode]: ...
 
-def typedesc(__encoded: str, /) -> TypeNode: ...
+class TypeResult:
+    @property
+    def node(self) -> Optional[TypeNode]: ...
+    @property
+    def error(self) -> TYPE_ERROR: ...
+    @property
+    def offset(self) -> int: ...
+    def ok(self) -> bool: ...
+
+class TypeCache:
+    class Stats:
+        @property
+        def hits(self) -> int: ...
+        @property
+        def misses(self) -> int: ...
+        @property
+        def size(self) -> int: ...
+        @property
+        def capacity(self) -> int: ...
+    def __init__(self, capacity: int = ...) -> None: ...
+    def typedesc(self, __encoded: str, /) -> Optional[TypeNode]: ...
+    def decode(self, __encoded: str, /) -> str: ...
+    def signature(self, __selector: str, __encoded: str, /) -> str: ...
+    def clear(self) -> None: ...
+    @property
+    def stats(self) -> TypeCache.Stats: ...
+    @staticmethod
+    def get_global() -> TypeCache: ...
+
+def typedesc(__encoded: str, /) -> Optional[TypeNode]: ...
+def parse_encoding(__encoded: str, /) -> TypeResult: ...
 def decode(__desc: TypeNode, /) -> str: ...
 def signature(__selector: str, __encoded: str, /) -> str: ...
 
@@ -194,6 +233,7 @@ class Class(umbrellacxx.InProcess):
     def meta_class(self) -> Optional[Class]: ...
     def has_super_class(self) -> bool: ...
     def has_meta_class(self) -> bool: ...
+    def is_imported(self) -> bool: ...
     def get_decl(self) -> str: ...
 
 
@@ -220,6 +260,106 @@ class Category(umbrellacxx.InProcess):
     def is_extension(self) -> bool: ...
     def get_decl(self) -> str: ...
 
+class ParseOptions:
+    max_depth: int
+    threads: int
+    lazy: bool
+    zero_copy: bool
+    mapped: bool
+    shared_strings: bool
+    def __init__(self) -> None: ...
+
+@final
+class MethodTable:
+    class OWNER_KIND:
+        CLASS: ClassVar[MethodTable.OWNER_KIND] = ...
+        CATEGORY: ClassVar[MethodTable.OWNER_KIND] = ...
+        PROTOCOL: ClassVar[MethodTable.OWNER_KIND] = ...
+        def __int__(self) -> int: ...
+    class FLAGS:
+        CLASS_METHOD: ClassVar[MethodTable.FLAGS] = ...
+        SMALL_METHOD: ClassVar[MethodTable.FLAGS] = ...
+        OPTIONAL: ClassVar[MethodTable.FLAGS] = ...
+        def __int__(self) -> int: ...
+    class Range:
+        @property
+        def begin(self) -> int: ...
+        @property
+        def end(self) -> int: ...
+        def __len__(self) -> int: ...
+    def __len__(self) -> int: ...
+    @property
+    def owner_kinds(self) -> List[int]: ...
+    @property
+    def owners(self) -> List[int]: ...
+    @property
+    def selectors(self) -> List[int]: ...
+    @property
+    def signatures(self) -> List[int]: ...
+    @property
+    def implementations(self) -> List[int]: ...
+    @property
+    def flags(self) -> List[int]: ...
+    def method(self, __index: int, /) -> Method: ...
+    def of_class(self, __index: int, /) -> MethodTable.Range: ...
+    def of_category(self, __index: int, /) -> MethodTable.Range: ...
+    def of_protocol(self, __index: int, /) -> MethodTable.Range: ...
+
+@final
+class EffectiveClass:
+    class it_categories(umbrellacxx.it[Category]):
+        pass
+    class it_protocols(umbrellacxx.it[Protocol]):
+        pass
+    @property
+    def cls(self) -> Class: ...
+    @property
+    def categories(self) -> EffectiveClass.it_categories: ...
+    @property
+    def methods(self) -> Class.it_methods: ...
+    @property
+    def class_methods(self) -> Class.it_methods: ...
+    @property
+    def properties(self) -> Class.it_properties: ...
+    @property
+    def protocols(self) -> EffectiveClass.it_protocols: ...
+
+@final
+class HierarchyIndex:
+    class Range:
+        @property
+        def begin(self) -> int: ...
+        @property
+        def end(self) -> int: ...
+        def __len__(self) -> int: ...
+    NONE: ClassVar[int] = ...
+    def __len__(self) -> int: ...
+    def find(self, __cls: Class, /) -> int: ...
+    @overload
+    def is_subclass_of(self, __node: int, __base: int, /) -> bool: ...
+    @overload
+    def is_subclass_of(self, __cls: Class, __base: Class, /) -> bool: ...
+    def subclasses_of(self, __node: int, /) -> HierarchyIndex.Range: ...
+    def children_of(self, __node: int, /) -> HierarchyIndex.Range: ...
+    @property
+    def children(self) -> List[int]: ...
+    def class_(self, __node: int, /) -> Class: ...
+    def parent(self, __node: int, /) -> int: ...
+    def depth(self, __node: int, /) -> int: ...
+
+@final
+class ConformanceIndex:
+    NONE: ClassVar[int] = ...
+    def __len__(self) -> int: ...
+    def find(self, __name: str, /) -> int: ...
+    def conforms_to(self, __node: int, __protocol: int, /) -> bool: ...
+    def protocol_conforms_to(self, __id: int, __protocol: int, /) -> bool: ...
+    def conforming_classes(self, __protocol: int, /) -> List[int]: ...
+    def categories_of(self, __node: int, /) -> HierarchyIndex.Range: ...
+    @property
+    def categories(self) -> List[int]: ...
+    def protocol(self, __id: int, /) -> Protocol: ...
+
 @final
 class ABIObjectiveC(umbrellacxx.ABIBase):
     class it_categories(umbrellacxx.it[Category]):
@@ -234,9 +374,30 @@ class ABIObjectiveC(umbrellacxx.ABIBase):
     def protocols(self) -> ABIObjectiveC.it_protocols: ...
     @property
     def categories(self) -> ABIObjectiveC.it_categories: ...
+    @property
+    def options(self) -> ParseOptions: ...
     def get_class(self, __name: str, /) -> Optional[Class]: ...
     def get_category(self, __name: str, /) -> Optional[Category]: ...
     def get_protocol(self, __name: str, /) -> Optional[Protocol]: ...
+    @property
+    def method_table(self) -> MethodTable: ...
+    def find_selector(self, __selector: str, /) -> List[int]: ...
+    def method_at(self, __address: int, /) -> Optional[Method]: ...
+    @property
+    def hierarchy(self) -> HierarchyIndex: ...
+    @property
+    def conformance(self) -> ConformanceIndex: ...
+    def conforms_to(self, __cls: Class, __protocol: str, /) -> bool: ...
+    def effective_class(self, __cls: Class, /) -> Optional[EffectiveClass]: ...
+    def string(self, __handle: int, /) -> str: ...
 
 
-def parse(file_name: str) -> Optional[ABIObjectiveC]: ...
+@overload
+def parse(file_name: str, options: ParseOptions = ...) -> Optional[ABIObjectiveC]: ...
+@overload
+def parse(
+    file_name: str, arch: umbrellacxx.ARCHITECTURE, options: ParseOptions = ...
+) -> Optional[ABIObjectiveC]: ...
+def parse_slices(
+    file_name: str, options: ParseOptions = ..., concurrent: bool = ...
+) -> List[Tuple[umbrellacxx.ARCHITECTURE, ABIObjectiveC]]: ...
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_UMBRELLA_ARENA_H__)
+#define _UMBRELLA_ARENA_H__
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+
+/**
+ * @brief A thread-safe bump allocator.
+ *
+ * Objects are placed into large chunks and are never freed individually.
+ * Destroying the arena releases all chunks at once, without running any
+ * destructors. Hence, only trivially destructible types can be created.
+ */
+class Arena {
+public:
+  /**
+   * @brief Default size of a chunk in bytes. Larger allocations get a chunk
+   *        of their own.
+   */
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+private:
+  std::vector<std::unique_ptr<std::byte[]>> chunks; /**< All chunks, the last one is in use. */
+  size_t used = 0;                                  /**< Bytes used in the current chunk. */
+  size_t capacity = 0;                              /**< Size of the current chunk. */
+  size_t total = 0;                                 /**< Bytes allocated by all chunks. */
+  mutable std::mutex mutex;                         /**< Guards all members. */
+
+public:
+  Arena() = default;
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * @brief Allocate uninitialized memory.
+   *
+   * @param size The number of bytes.
+   * @param alignment The alignment of the memory, must be a power of two.
+   * @return void* The allocated memory, valid as long as this arena.
+   */
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * @brief Create an object inside this arena.
+   *
+   * @param args The arguments passed to the constructor of T.
+   * @return T* The new object, valid as long as this arena.
+   */
+  template <typename T, typename... Args>
+  T* create(Args&&... args) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "arena objects are freed without running their destructor");
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Get the number of bytes reserved by all chunks.
+   *
+   * @return size_t The reserved memory in bytes.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Get the number of chunks.
+   *
+   * @return size_t The number of chunks.
+   */
+  size_t getChunkCount() const;
+};
+
+} // namespace umbrella
+
+#endif  // _UMBRELLA_ARENA_H__
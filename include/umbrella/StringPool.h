@@ -0,0 +1,122 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_UMBRELLA_STRING_POOL_H__)
+#define _UMBRELLA_STRING_POOL_H__
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+
+/**
+ * @brief A thread-safe table of unique strings.
+ *
+ * Every distinct string is stored once and is never moved or freed while
+ * the pool exists. Hence, two interned strings are equal if and only if
+ * their views share the same data pointer, and if and only if their handles
+ * are equal.
+ */
+class StringPool {
+public:
+  /**
+   * @brief Dense identifier of an interned string, starting at 0.
+   */
+  using Handle = uint32_t;
+
+private:
+  std::deque<std::string> storage;                     /**< Copies owned by this pool. */
+  std::vector<std::string_view> strings;               /**< Interned strings by handle. */
+  std::unordered_map<std::string_view, Handle> lookup; /**< String to handle lookup map. */
+  mutable std::mutex mutex;                            /**< Guards all members. */
+
+  /**
+   * @brief Intern a string, the mutex must be held by the caller.
+   */
+  Handle insert(std::string_view value, bool copy);
+
+public:
+  StringPool() = default;
+
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  /**
+   * @brief Intern a string and return its handle.
+   *
+   * @param value The string to intern.
+   * @param copy Whether the string has to be copied if it is new. If false,
+   *        the caller guarantees that value outlives this pool.
+   * @return Handle The handle of the interned string.
+   */
+  Handle add(std::string_view value, bool copy = true);
+
+  /**
+   * @brief Intern a string and return the stored view.
+   *
+   * @param value The string to intern.
+   * @param copy See add().
+   * @return std::string_view The interned string, valid as long as this pool.
+   */
+  std::string_view intern(std::string_view value, bool copy = true);
+
+  /**
+   * @brief Look up the handle of a string without interning it.
+   *
+   * @param value The string to look up.
+   * @param handle Receives the handle if the string is interned.
+   * @return bool True if the string is interned; otherwise, false.
+   */
+  bool find(std::string_view value, Handle& handle) const;
+
+  /**
+   * @brief Get an interned string by its handle.
+   *
+   * @param handle The handle returned by add().
+   * @return std::string_view The interned string or an empty view if the
+   *         handle is unknown.
+   */
+  std::string_view get(Handle handle) const;
+
+  /**
+   * @brief Get the number of distinct strings in this pool.
+   *
+   * @return size_t The number of interned strings.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Get the process-wide pool.
+   *
+   * The pool is never destroyed, thus all strings interned here stay valid
+   * until the process exits.
+   *
+   * @return std::shared_ptr<StringPool> The shared pool.
+   */
+  static std::shared_ptr<StringPool> global();
+};
+
+} // namespace umbrella
+
+#endif  // _UMBRELLA_STRING_POOL_H__
@@ -16,6 +16,10 @@
 #if !defined(__UMBRELLA_OBJC_H__)
 #define __UMBRELLA_OBJC_H__
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "umbrella/objc/ABI.h"
 #include "umbrella/objc/Category.h"
 #include "umbrella/objc/Class.h"
@@ -25,6 +29,7 @@
 #include "umbrella/objc/Protocol.h"
 #include "umbrella/objc/TypeEncoding.h"
 #include "umbrella/objc/Types.h"
+#include "umbrella/objc/Visitor.h"
 
 namespace umbrella {
 namespace objc {
@@ -38,15 +43,57 @@ namespace objc {
  *
  * @param fileName The name of the file to parse Objective-C ABI information
  *                 from.
+ * @param options Options used while parsing.
  * @return std::unique_ptr<objc::ABIObjectiveC> A unique pointer to the parsed
  *         ABIObjectiveC object.
  *
+ * The first arm64 (or arm64e) slice will be selected, if there is none the
+ * first x86_64 slice.
+ *
  * @note You should call this function to obtain Objective-C ABI information
  * from a MachO file only. The returned unique pointer manages the ownership
- * of the ABIObjectiveC object. Make sure to handle the unique pointer properly
- * to prevent resource leaks.
+ * of the ABIObjectiveC object, which in turn owns the parsed Mach-O image.
+ * Make sure to handle the unique pointer properly to prevent resource leaks.
+ */
+std::unique_ptr<objc::ABIObjectiveC> parseObjC(const std::string& fileName,
+                                               const ParseOptions& options = ParseOptions());
+
+/**
+ * @brief Parse Objective-C ABI information of a specific slice.
+ *
+ * @param fileName The name of the file to parse Objective-C ABI information
+ *                 from.
+ * @param arch The architecture of the slice to parse.
+ * @param options Options used while parsing.
+ * @return std::unique_ptr<objc::ABIObjectiveC> A unique pointer to the parsed
+ *         ABIObjectiveC object, or nullptr if there is no such slice.
+ */
+std::unique_ptr<objc::ABIObjectiveC> parseObjC(const std::string& fileName, Architecture arch,
+                                               const ParseOptions& options = ParseOptions());
+
+/**
+ * @brief Objective-C ABI information of a single slice.
+ */
+struct Slice {
+  Architecture architecture;          /**< The architecture of the slice. */
+  std::unique_ptr<ABIObjectiveC> abi; /**< The parsed ABI information. */
+};
+
+/**
+ * @brief Parse Objective-C ABI information of all slices of a (fat) file.
+ *
+ * The file is parsed only once, slices with an unsupported architecture
+ * are skipped.
+ *
+ * @param fileName The name of the file to parse Objective-C ABI information
+ *                 from.
+ * @param options Options used while parsing each slice.
+ * @param concurrent Whether the slices are parsed on multiple threads.
+ * @return std::vector<Slice> One entry per supported slice, in file order.
  */
-std::unique_ptr<objc::ABIObjectiveC> parseObjC(const std::string& fileName);
+std::vector<Slice> parseObjCSlices(const std::string& fileName,
+                                   const ParseOptions& options = ParseOptions(),
+                                   bool concurrent = true);
 
 } // namespace objc
 } // namespace umbrella
@@ -17,24 +17,91 @@
 #define _UMBRELLA_OBJC_ABI_H__
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "umbrella/Arena.h"
+#include "umbrella/StringPool.h"
 #include "umbrella/visibility.h"
 
 #include "umbrella/ObjC/Category.h"
 #include "umbrella/ObjC/Class.h"
+#include "umbrella/ObjC/ConformanceIndex.h"
+#include "umbrella/ObjC/EffectiveClass.h"
+#include "umbrella/ObjC/HierarchyIndex.h"
+#include "umbrella/ObjC/ImplementationIndex.h"
+#include "umbrella/ObjC/MethodTable.h"
+#include "umbrella/ObjC/SelectorIndex.h"
 #include "umbrella/ObjC/Protocol.h"
 #include "umbrella/iterators.h"
 #include "umbrella/runtime.h"
 
 namespace umbrella {
+
+class ChainedFixups;
+class ImportIndex;
+
 namespace objc {
 
 class Class;
 class Protocol;
 class Category;
+class Method;
+class IVar;
+class Property;
+
+/**
+ * @brief Options controlling how Objective-C metadata is parsed.
+ */
+struct ParseOptions {
+  /**
+   * Maximum number of superclass/metaclass (or adopted protocol) links
+   * followed from a single object. Deeper references stay unresolved, which
+   * bounds the work done on malformed binaries.
+   */
+  uint32_t maxDepth = 64;
+
+  /**
+   * Number of threads used to parse the entries of __objc_classlist,
+   * __objc_catlist and __objc_protolist. A value of 0 selects the number
+   * of hardware threads. The order of all parsed lists does not depend on
+   * this value.
+   */
+  uint32_t threads = 1;
+
+  /**
+   * If set, the methods, instance variables, properties and protocols of
+   * classes, categories and protocols are decoded on first access instead
+   * of while parsing. Decoding is thread-safe.
+   */
+  bool lazy = false;
+
+  /**
+   * If set, names, selectors and type encodings will point directly into
+   * the mapped segment contents instead of being copied. They stay valid
+   * as long as the image stream (shared by the ABI object). Only supported
+   * with a MachOStream or MappedMachOStream, other streams always copy.
+   */
+  bool zeroCopy = false;
+
+  /**
+   * Used by parseObjC only: memory-map the file and read just the Mach-O
+   * header, segments and sections instead of running the full LIEF parser.
+   * The resulting ABI provides no target binary (see ABIBase::hasBinary).
+   */
+  bool mapped = false;
+
+  /**
+   * If set, strings are interned in the process-wide StringPool::global()
+   * instead of a pool owned by the ABI object. Equal strings of different
+   * images then share the same storage, and stay valid until the process
+   * exits. This implies copying the strings (see zeroCopy).
+   */
+  bool sharedStrings = false;
+};
 
 /**
  * @brief Class representing Objective-C ABI information.
@@ -43,6 +110,13 @@ class Category;
  */
 class ABIObjectiveC final : public ABIBase {
 public:
+  friend class Class;    /**< Allowing Class to intern parsed objects. */
+  friend class Protocol; /**< Allowing Protocol to intern parsed objects. */
+  friend class Category; /**< Allowing Category to intern parsed objects. */
+  friend class Method;   /**< Allowing Method to allocate from the arena. */
+  friend class IVar;     /**< Allowing IVar to allocate from the arena. */
+  friend class Property; /**< Allowing Property to allocate from the arena. */
+
   using TargetBinary = typename ABIBase::TargetBinary;
   using TargetBinaryStream = typename ABIBase::TargetBinaryStream;
 
@@ -50,15 +124,20 @@ public:
   using ClassList = std::vector<std::shared_ptr<Class>>;
   using CategoryList = std::vector<std::shared_ptr<Category>>;
 
-  using ClassLookup = std::unordered_map<std::string, Class*>;
-  using ProtocolLookup = std::unordered_map<std::string, Protocol*>;
-  using CategoryLookup = std::unordered_map<std::string, Category*>;
+  using ClassLookup = std::unordered_map<std::string_view, Class*>;
+  using ProtocolLookup = std::unordered_map<std::string_view, Protocol*>;
+  using CategoryLookup = std::unordered_map<std::string_view, Category*>;
+
+  using ClassCache = std::unordered_map<uintptr_t, std::shared_ptr<Class>>;
+  using ProtocolCache = std::unordered_map<uintptr_t, std::shared_ptr<Protocol>>;
+  using CategoryCache = std::unordered_map<uintptr_t, std::shared_ptr<Category>>;
 
   using it_classes = LIEF::const_ref_iterator<const ClassList&, Class*>;
   using it_protocols = LIEF::const_ref_iterator<const ProtocolList&, Protocol*>;
   using it_categories = LIEF::const_ref_iterator<const CategoryList&, Category*>;
 
 private:
+  ParseOptions options;    /**< Options used while parsing. */
   ClassList classes;       /**< List of classes. */
   ProtocolList protocols;  /**< List of protocols. */
   CategoryList categories; /**< List of categories. */
@@ -67,25 +146,250 @@ private:
   ProtocolLookup protocolLookup; /**< Protocol name to protocol object lookup map. */
   CategoryLookup categoryLookup; /**< Category name to category object lookup map. */
 
+  // Every class_t, protocol_t and category_t is materialized only once and
+  // shared by all objects referencing it (e.g. superclasses or adopted
+  // protocols). The key is the fixed-up virtual address of the raw struct.
+  ClassCache classCache;       /**< Class address to class object cache. */
+  ProtocolCache protocolCache; /**< Protocol address to protocol object cache. */
+  CategoryCache categoryCache; /**< Category address to category object cache. */
+  std::vector<std::shared_ptr<Protocol>> forgottenProtocols; /**< See forget(). */
+  std::mutex cacheMutex;       /**< Guards all caches while parsing in parallel. */
+  std::mutex streamMutex;      /**< Guards the shared stream if it can't be forked. */
+
+  // Methods, instance variables and properties are owned by this arena
+  // and referenced by plain pointers, they are all released at once.
+  Arena arena; /**< Storage of all members of classes, protocols and categories. */
+
+  // Strings referenced by the model are interned, so that repeated names,
+  // selectors and type encodings are stored once. The pool refers to the
+  // segment contents (zero-copy) or to its own copies.
+  std::shared_ptr<StringPool> stringPool; /**< Pool of all strings referenced by the model. */
+
+  mutable std::unique_ptr<MethodTable> methodTable; /**< Columnar view of all methods. */
+  mutable std::once_flag methodTableOnce;           /**< Guards building the method table. */
+  mutable std::unique_ptr<SelectorIndex> selectorIndex; /**< Selector to method rows index. */
+  mutable std::once_flag selectorIndexOnce;             /**< Guards building the selector index. */
+  mutable std::unique_ptr<ImplementationIndex> implementationIndex; /**< Address to method index. */
+  mutable std::once_flag implementationIndexOnce; /**< Guards building the address index. */
+  mutable std::unique_ptr<HierarchyIndex> hierarchyIndex; /**< Superclass and subclass index. */
+  mutable std::once_flag hierarchyIndexOnce;              /**< Guards building the hierarchy. */
+  mutable std::unique_ptr<ConformanceIndex> conformanceIndex; /**< Protocol conformance index. */
+  mutable std::once_flag conformanceIndexOnce;                /**< Guards building the conformance. */
+  mutable std::vector<EffectiveClass> effectiveClasses; /**< Merged view of each hierarchy node. */
+  mutable std::once_flag effectiveClassesOnce;           /**< Guards merging the categories. */
+  bool zeroCopy;                          /**< Whether strings are read without copying. */
+
+  std::unique_ptr<ChainedFixups> fixups; /**< Decoded chained fixups, if the image has any. */
+  std::unique_ptr<ImportIndex> imports;  /**< Bind sites of images without chained fixups. */
+
+  // Classes of other images are represented by placeholders that only
+  // store their name. They are shared by all references to the same symbol.
+  std::unordered_map<std::string_view, std::shared_ptr<Class>> importedClasses;
+
 public:
   /**
    * @brief Constructor for ABIObjectiveC.
    *
-   * @param _Binary Pointer to the target binary.
+   * @param _Binary Shared pointer to the target binary, kept alive by this object.
    * @param _Stream Shared pointer to the target binary stream.
+   * @param _Options Options used while parsing.
    */
-  ABIObjectiveC(const TargetBinary* _Binary, std::shared_ptr<TargetBinaryStream> _Stream)
-    : ABIBase(_Binary, _Stream){};
+  ABIObjectiveC(std::shared_ptr<const TargetBinary> _Binary,
+                std::shared_ptr<TargetBinaryStream> _Stream,
+                const ParseOptions& _Options = ParseOptions());
+
+  /**
+   * @brief Constructor for ABIObjectiveC that does not own the binary.
+   *
+   * @param _Binary Pointer to the target binary, must outlive this object.
+   * @param _Stream Shared pointer to the target binary stream.
+   * @param _Options Options used while parsing.
+   */
+  ABIObjectiveC(const TargetBinary* _Binary, std::shared_ptr<TargetBinaryStream> _Stream,
+                const ParseOptions& _Options = ParseOptions());
+
+  /**
+   * @brief Destructor for ABIObjectiveC.
+   *
+   * Releases all references between cached objects, so that cyclic
+   * class and protocol graphs are freed as well.
+   */
+  ~ABIObjectiveC();
 
   /**
    * @brief Static function to parse Objective-C information.
    *
-   * @param _Binary Reference to the target binary.
+   * @param _Binary Reference to the target binary, must outlive the result.
    * @param _Stream Shared pointer to the target binary stream.
+   * @param _Options Options used while parsing.
    * @return std::unique_ptr<ABIObjectiveC> A unique pointer to the parsed data.
    */
   static std::unique_ptr<ABIObjectiveC> parse(const TargetBinary& _Binary,
-                                              std::shared_ptr<TargetBinaryStream> _Stream);
+                                              std::shared_ptr<TargetBinaryStream> _Stream,
+                                              const ParseOptions& _Options = ParseOptions());
+
+  /**
+   * @brief Static function to parse Objective-C information.
+   *
+   * In contrast to the overload above, the returned ABI shares ownership of
+   * the binary. Hence, all parsed objects (and lazily decoded members) stay
+   * valid after the caller has released its reference.
+   *
+   * @param _Binary Shared pointer to the target binary.
+   * @param _Stream Shared pointer to the target binary stream.
+   * @param _Options Options used while parsing.
+   * @return std::unique_ptr<ABIObjectiveC> A unique pointer to the parsed data.
+   */
+  static std::unique_ptr<ABIObjectiveC> parse(std::shared_ptr<const TargetBinary> _Binary,
+                                              std::shared_ptr<TargetBinaryStream> _Stream,
+                                              const ParseOptions& _Options = ParseOptions());
+
+  /**
+   * @brief Static function to parse Objective-C information from a stream only.
+   *
+   * The stream must describe the image layout itself (e.g. a memory-mapped
+   * Mach-O file), as there is no target binary to look up sections in.
+   *
+   * @param _Stream Shared pointer to the target binary stream.
+   * @param _Options Options used while parsing.
+   * @return std::unique_ptr<ABIObjectiveC> A unique pointer to the parsed data.
+   */
+  static std::unique_ptr<ABIObjectiveC> parse(std::shared_ptr<TargetBinaryStream> _Stream,
+                                              const ParseOptions& _Options = ParseOptions());
+
+  /**
+   * @brief Read a NULL-terminated string at the given address.
+   *
+   * The string is interned (see getStringPool()), hence equal strings
+   * share the same data pointer. The returned view stays valid as long as
+   * this ABI object.
+   *
+   * @param address The fixed-up address of the string.
+   * @return std::string_view The string or an empty view if it can't be read.
+   */
+  std::string_view readString(uintptr_t address);
+
+  /**
+   * @brief Get the pool all strings of the model are interned in.
+   *
+   * @return const StringPool& The pool of this ABI object or the global one.
+   */
+  inline const StringPool& getStringPool() const { return *stringPool; }
+
+  /**
+   * @brief Get the arena owning all methods, instance variables and properties.
+   *
+   * @return const Arena& The arena of this ABI object.
+   */
+  inline const Arena& getArena() const { return arena; }
+
+  /**
+   * @brief Get a columnar view of all methods of this image.
+   *
+   * The table is built on first access, which decodes all lazily parsed
+   * members. Selectors and signatures are stored as handles into the
+   * string pool (see getStringPool()).
+   *
+   * @return const MethodTable& The method table.
+   */
+  const MethodTable& getMethodTable() const;
+
+  /**
+   * @brief Get the index from selectors to method table rows.
+   *
+   * The index is built on first access, together with the method table.
+   *
+   * @return const SelectorIndex& The selector index.
+   */
+  const SelectorIndex& getSelectorIndex() const;
+
+  /**
+   * @brief Find every method implementing or declaring a selector.
+   *
+   * Includes methods of classes, metaclasses, categories and protocols.
+   *
+   * @param selector The selector, e.g. "application:openURL:options:".
+   * @return std::vector<uint32_t> Rows of the method table (see getMethodTable()).
+   */
+  std::vector<uint32_t> findSelector(std::string_view selector) const;
+
+  /**
+   * @brief Get the sorted index of all implementation addresses.
+   *
+   * The index is built on first access, together with the method table.
+   *
+   * @return const ImplementationIndex& The implementation index.
+   */
+  const ImplementationIndex& getImplementationIndex() const;
+
+  /**
+   * @brief Find the method whose implementation encloses an address.
+   *
+   * @param address The code address, e.g. of a stripped stack frame.
+   * @return const Method* The method with the closest implementation at or
+   *         below the address, or nullptr if there is none or the address is
+   *         past the end of __text.
+   */
+  const Method* methodAt(uintptr_t address) const;
+
+  /**
+   * @brief Get the class hierarchy of the image.
+   *
+   * The index is built on first access and answers subclass queries
+   * without following superclass pointers.
+   *
+   * @return const HierarchyIndex& The hierarchy index.
+   */
+  const HierarchyIndex& getHierarchyIndex() const;
+
+  /**
+   * @brief Get the transitive protocol conformance of all classes.
+   *
+   * The index is built on first access, together with the hierarchy index
+   * whose nodes it refers to.
+   *
+   * @return const ConformanceIndex& The conformance index.
+   */
+  const ConformanceIndex& getConformanceIndex() const;
+
+  /**
+   * @brief Check whether a class conforms to a protocol.
+   *
+   * Protocols adopted by superclasses, categories and other adopted
+   * protocols are taken into account.
+   *
+   * @param cls The class.
+   * @param protocol The name of the protocol.
+   * @return bool True if the class conforms to the protocol.
+   */
+  bool conformsTo(const Class* cls, std::string_view protocol) const;
+
+  /**
+   * @brief Get the merged views of all classes.
+   *
+   * The views are built on first access. View i belongs to node i of the
+   * hierarchy index, which includes imported classes extended by a
+   * category of this image.
+   *
+   * @return const std::vector<EffectiveClass>& The merged classes.
+   */
+  const std::vector<EffectiveClass>& getEffectiveClasses() const;
+
+  /**
+   * @brief Get a class with the members of all its categories attached.
+   *
+   * @param cls The class.
+   * @return const EffectiveClass* The merged view or nullptr if the class is
+   *         not part of the hierarchy index (e.g. a metaclass).
+   */
+  const EffectiveClass* getEffectiveClass(const Class* cls) const;
+
+  /**
+   * @brief Get the options used to parse this ABI.
+   *
+   * @return const ParseOptions& The parse options.
+   */
+  inline const ParseOptions& getOptions() const { return options; }
 
   /**
    * @brief Get a pointer to a class by name.
@@ -139,11 +443,55 @@ public:
   /**
    * @brief Fix a pointer value based its representation.
    *
+   * Images with chained fixups (LC_DYLD_CHAINED_FIXUPS) are decoded using
+   * their pointer format. Binds to imported symbols resolve to 0, see
+   * getImportName().
+   *
    * @param ptr The pointer value to fix.
    * @return uintptr_t The fixed pointer value.
    */
   uintptr_t fixPointer(uintptr_t ptr) const;
 
+  /**
+   * @brief Fix the pointer stored at the given address.
+   *
+   * Uses the table built from the chained fixups and falls back to
+   * fixPointer() for all other images.
+   *
+   * @param location The address the pointer is stored at.
+   * @param ptr The raw pointer value stored at this address.
+   * @return uintptr_t The fixed pointer value.
+   */
+  uintptr_t fixPointerAt(uintptr_t location, uintptr_t ptr) const;
+
+  /**
+   * @brief Get the name of the symbol a pointer value is bound to.
+   *
+   * @param ptr The raw pointer value.
+   * @return std::string_view The imported symbol name (e.g. _OBJC_CLASS_$_NSObject),
+   *         or an empty view if the pointer is not a bind.
+   */
+  std::string_view getImportName(uintptr_t ptr) const;
+
+  /**
+   * @brief Get the name of the symbol the pointer at the given address is bound to.
+   *
+   * Binds are taken from the chained fixups or, for all other images, from
+   * the bind opcodes of LC_DYLD_INFO.
+   *
+   * @param location The address the pointer is stored at.
+   * @return std::string_view The imported symbol name, or an empty view if
+   *         there is no bind at this address.
+   */
+  std::string_view getImportNameAt(uintptr_t location) const;
+
+  /**
+   * @brief Check whether the image uses chained fixups.
+   *
+   * @return true if pointers are decoded from LC_DYLD_CHAINED_FIXUPS.
+   */
+  inline bool hasChainedFixups() const { return fixups != nullptr; }
+
   /**
    * @brief Get the number of classes in the ABI.
    *
@@ -166,6 +514,90 @@ public:
   inline size_t getProtocolCount() const { return protocols.size(); }
 
 private:
+  /**
+   * @brief Parse all classes, categories and protocols of the image.
+   */
+  void load();
+
+  /**
+   * @brief Resolve a class reference that is bound to another image.
+   *
+   * @param location The address the class pointer is stored at.
+   * @param ptr The raw pointer value stored at this address.
+   * @return std::shared_ptr<Class> The placeholder of the imported class, or
+   *         nullptr if the pointer is not bound to an Objective-C class.
+   */
+  std::shared_ptr<Class> importedClass(uintptr_t location, uintptr_t ptr);
+
+  /**
+   * @brief Run a function with a private stream cursor on the calling thread.
+   *
+   * Used to decode members lazily, which may happen on any thread at any
+   * time after parsing.
+   *
+   * @param fn The function to run, it should access the data via stream().
+   */
+  template <typename F>
+  void withCursor(F&& fn) {
+    if (std::shared_ptr<TargetBinaryStream> cursor = fork()) {
+      ScopedCursor bound(*this, std::move(cursor));
+      fn();
+    } else {
+      std::lock_guard<std::mutex> lock(streamMutex);
+      fn();
+    }
+  }
+
+  /**
+   * @brief Lookup an address in the specified cache.
+   *
+   * @tparam T The type of the objects in the cache.
+   * @param address The fixed-up address of the raw struct.
+   * @param cache The cache to search in.
+   * @param result Receives the cached object (nullptr for invalid addresses).
+   * @return bool True if the address has been visited before.
+   */
+  template <typename T>
+  bool cached(uintptr_t address, const std::unordered_map<uintptr_t, std::shared_ptr<T>>& cache,
+              std::shared_ptr<T>& result) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto res = cache.find(address);
+    if (res != std::end(cache)) {
+      result = res->second;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Register an object in the specified cache.
+   *
+   * @tparam T The type of the objects in the cache.
+   * @param address The fixed-up address of the raw struct.
+   * @param cache The cache to insert into.
+   * @param object The parsed object or nullptr to mark an invalid address.
+   * @return std::shared_ptr<T> The cached object, which differs from the given
+   *         one if another thread registered the same address first.
+   */
+  template <typename T>
+  std::shared_ptr<T> intern(uintptr_t address,
+                            std::unordered_map<uintptr_t, std::shared_ptr<T>>& cache,
+                            std::shared_ptr<T> object) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cache.emplace(address, std::move(object)).first->second;
+  }
+
+  /**
+   * @brief Remove a protocol from the cache, so that its address will be
+   *        parsed again (e.g. because its adopted protocols are incomplete).
+   *
+   * The protocol is kept alive until this object is destroyed, as others
+   * may already reference it.
+   *
+   * @param protocol The protocol registered by intern().
+   */
+  void forget(const std::shared_ptr<Protocol>& protocol);
+
   /**
    * @brief Lookup a name in the specified map.
    *
@@ -175,7 +607,7 @@ private:
    * @return const T* A pointer to the found object. Returns nullptr if not found.
    */
   template <typename T>
-  const T* lookup(const std::string& name, std::unordered_map<std::string, T*>& map) {
+  const T* lookup(std::string_view name, std::unordered_map<std::string_view, T*>& map) {
     auto res = map.find(name);
     if (res != std::end(map)) {
       return res->second;
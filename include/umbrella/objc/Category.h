@@ -17,7 +17,9 @@
 #define __UMBRELLA_OBJC_CATEGORY_H__
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "umbrella/visibility.h"
@@ -40,8 +42,10 @@ class ABIObjectiveC;
  */
 class Category final : public InProcess {
 public:
-  using MethodList = std::vector<std::shared_ptr<Method>>;
-  using PropertyList = std::vector<std::shared_ptr<Property>>;
+  friend class ABIObjectiveC; /**< Allowing ABIObjectiveC class to access private members. */
+
+  using MethodList = std::vector<Method*>;
+  using PropertyList = std::vector<Property*>;
   using ProtocolList = std::vector<std::shared_ptr<Protocol>>;
 
   using it_methods = LIEF::const_ref_iterator<const MethodList&, Method*>;
@@ -49,13 +53,16 @@ public:
   using it_protocols = LIEF::const_ref_iterator<const ProtocolList&, Protocol*>;
 
 private:
-  std::string name;                 /**< The name of the category. */
+  std::string_view name;            /**< The name of the category. */
   std::shared_ptr<Class> baseClass; /**< Pointer to the base class associated with the category. */
   MethodList instanceMethods;       /**< List of instance methods defined in the category. */
   MethodList classMethods;          /**< List of class methods defined in the category. */
   PropertyList instanceProperties;  /**< List of properties defined in the category. */
   ProtocolList baseProtocols;       /**< List of protocols conformed to by the category. */
 
+  ABIObjectiveC* lazyABI{nullptr};    /**< ABI used to decode members on first access. */
+  mutable std::once_flag membersOnce; /**< Guards the lazy decoding of members. */
+
 public:
   /**
    * @brief Static function to parse an Objective-C category.
@@ -65,6 +72,21 @@ public:
    */
   static std::shared_ptr<Category> parse(ABIObjectiveC& abi);
 
+private:
+  /**
+   * @brief Parse methods, properties and protocols.
+   *
+   * @param abi Reference to the ABIObjectiveC object.
+   * @param raw The raw category_t.
+   */
+  void parseMembers(ABIObjectiveC& abi, const category_t& raw);
+
+  /**
+   * @brief Decode all members if they were not decoded while parsing.
+   */
+  void materialize() const;
+
+public:
   /**
    * @brief Default constructor for the Category class.
    * Initializes the address to 0.
@@ -76,28 +98,40 @@ public:
    *
    * @return it_methods An iterator to the instance methods.
    */
-  inline it_methods getInstanceMethods() const { return instanceMethods; }
+  inline it_methods getInstanceMethods() const {
+    materialize();
+    return instanceMethods;
+  }
 
   /**
    * @brief Get an iterator to the class methods defined in the category.
    *
    * @return it_methods An iterator to the class methods.
    */
-  inline it_methods getClassMethods() const { return classMethods; }
+  inline it_methods getClassMethods() const {
+    materialize();
+    return classMethods;
+  }
 
   /**
    * @brief Get an iterator to the instance properties defined in the category.
    *
    * @return it_properties An iterator to the instance properties.
    */
-  inline it_properties getInstanceProperties() const { return instanceProperties; }
+  inline it_properties getInstanceProperties() const {
+    materialize();
+    return instanceProperties;
+  }
 
   /**
    * @brief Get an iterator to the protocols conformed to by the category.
    *
    * @return it_protocols An iterator to the base protocols.
    */
-  inline it_protocols getBaseProtocols() const { return baseProtocols; }
+  inline it_protocols getBaseProtocols() const {
+    materialize();
+    return baseProtocols;
+  }
 
   /**
    * @brief Get a pointer to the base class associated with the category.
@@ -117,9 +151,9 @@ public:
   /**
    * @brief Get the name of the category.
    *
-   * @return const std::string The name of the category.
+   * @return std::string_view The name of the category.
    */
-  inline const std::string getName() const { return name; }
+  inline std::string_view getName() const { return name; }
 
   /**
    * @brief Get the declaration of this category.
@@ -127,7 +161,18 @@ public:
    * @return std::string An Objective-C source code snippet representing the
    *         declaration of the category.
    */
-  std::string getDeclaration() const;
+  inline std::string getDeclaration() const {
+    std::string result;
+    appendDeclaration(result);
+    return result;
+  }
+
+  /**
+   * @brief Append the declaration of this category to an existing buffer.
+   *
+   * @param _Out The buffer, may be reused for many declarations.
+   */
+  void appendDeclaration(std::string& _Out) const;
 };
 
 } // namespace objc
@@ -17,7 +17,9 @@
 #define _UMBRELLA_OBJC_CLASS_H__
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "umbrella/visibility.h"
@@ -38,10 +40,12 @@ class ABIObjectiveC;
  */
 class Class final : public InProcess {
 public:
-  using MethodList = std::vector<std::shared_ptr<Method>>;
-  using PropertyList = std::vector<std::shared_ptr<Property>>;
+  friend class ABIObjectiveC; /**< Allowing ABIObjectiveC class to access private members. */
+
+  using MethodList = std::vector<Method*>;
+  using PropertyList = std::vector<Property*>;
   using ProtocolList = std::vector<std::shared_ptr<Protocol>>;
-  using IVarList = std::vector<std::shared_ptr<IVar>>;
+  using IVarList = std::vector<IVar*>;
 
   using it_methods = LIEF::const_ref_iterator<const MethodList&, Method*>;
   using it_properties = LIEF::const_ref_iterator<const PropertyList&, Property*>;
@@ -49,8 +53,9 @@ public:
   using it_ivars = LIEF::const_ref_iterator<const IVarList&, IVar*>;
 
 private:
-  std::string name; /**< The name of the class. */
-  uint32_t flags;   /**< Flags associated with the class. */
+  std::string_view name; /**< The name of the class. */
+  uint32_t flags;        /**< Flags associated with the class. */
+  bool imported{false};  /**< Whether the class is defined by another image. */
 
   std::shared_ptr<Class> superClass; /**< Pointer to the superclass. */
   std::shared_ptr<Class> metaClass;  /**< Pointer to the metaclass. */
@@ -59,6 +64,10 @@ private:
   ProtocolList protocols;            /**< List of protocols conformed to by the class. */
   PropertyList properties;           /**< List of properties defined in the class. */
 
+  ABIObjectiveC* lazyABI{nullptr};    /**< ABI used to decode members on first access. */
+  uintptr_t roAddress{0};             /**< Address of the class_ro_t storing all members. */
+  mutable std::once_flag membersOnce; /**< Guards the lazy decoding of members. */
+
 public:
   /**
    * @brief Static function to parse an Objective-C class.
@@ -68,6 +77,31 @@ public:
    */
   static std::shared_ptr<Class> parse(ABIObjectiveC& abi);
 
+private:
+  /**
+   * @brief Parse the class at the current stream position without resolving
+   *        its superclass and metaclass.
+   *
+   * @param abi Reference to the ABIObjectiveC object.
+   * @return std::shared_ptr<Class> A shared pointer to the parsed Class object.
+   */
+  static std::shared_ptr<Class> parseData(ABIObjectiveC& abi);
+
+  /**
+   * @brief Parse methods, instance variables, protocols and properties.
+   *
+   * @param abi Reference to the ABIObjectiveC object.
+   * @param raw The class_ro_t of this class.
+   */
+  void parseMembers(ABIObjectiveC& abi, const class_ro_t& raw);
+
+  /**
+   * @brief Decode all members if they were not decoded while parsing.
+   */
+  void materialize() const;
+
+public:
+
   /**
    * @brief Default constructor for the Class class.
    * Initializes the address to 0.
@@ -77,9 +111,9 @@ public:
   /**
    * @brief Get the name of the class.
    *
-   * @return const std::string& The name of the class.
+   * @return std::string_view The name of the class.
    */
-  inline const std::string& getName() const { return name; }
+  inline std::string_view getName() const { return name; }
 
   /**
    * @brief Get the flags associated with the class.
@@ -93,28 +127,51 @@ public:
    *
    * @return it_methods An iterator to the methods.
    */
-  inline it_methods getMethods() const { return methods; }
+  inline it_methods getMethods() const {
+    materialize();
+    return methods;
+  }
 
   /**
    * @brief Get an iterator to the instance variables defined in the class.
    *
    * @return it_ivars An iterator to the instance variables.
    */
-  inline it_ivars getIVars() const { return ivars; }
+  inline it_ivars getIVars() const {
+    materialize();
+    return ivars;
+  }
 
   /**
    * @brief Get an iterator to the protocols conformed to by the class.
    *
    * @return it_protocols An iterator to the conformed protocols.
    */
-  inline it_protocols getProtocols() const { return protocols; }
+  inline it_protocols getProtocols() const {
+    materialize();
+    return protocols;
+  }
 
   /**
    * @brief Get an iterator to the properties defined in the class.
    *
    * @return it_properties An iterator to the properties.
    */
-  inline it_properties getProperties() const { return properties; }
+  inline it_properties getProperties() const {
+    materialize();
+    return properties;
+  }
+
+  /**
+   * @brief Check if the class is defined by another image.
+   *
+   * Imported classes (e.g. the superclass NSObject) are only known by the
+   * symbol they are bound to. Their name is taken from this symbol and
+   * all other attributes are empty.
+   *
+   * @return bool True if the class is imported; otherwise, false.
+   */
+  inline bool isImported() const { return imported; }
 
   /**
    * @brief Check if the class has a superclass.
@@ -152,7 +209,18 @@ public:
    * @return std::string An Objective-C source code snippet representing the
    *         declaration of the class.
    */
-  std::string getDeclaration() const;
+  inline std::string getDeclaration() const {
+    std::string result;
+    appendDeclaration(result);
+    return result;
+  }
+
+  /**
+   * @brief Append the declaration of this class to an existing buffer.
+   *
+   * @param _Out The buffer, may be reused for many declarations.
+   */
+  void appendDeclaration(std::string& _Out) const;
 };
 
 } // namespace objc
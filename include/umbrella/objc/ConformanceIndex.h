@@ -0,0 +1,165 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_CONFORMANCE_INDEX_H__)
+#define __UMBRELLA_OBJC_CONFORMANCE_INDEX_H__
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "umbrella/ObjC/HierarchyIndex.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+class ABIObjectiveC;
+class Protocol;
+
+/**
+ * @brief Transitive protocol conformance of all classes of an image.
+ *
+ * Every distinct protocol name gets a dense ID. Each protocol and each
+ * node of the HierarchyIndex stores a bitset of all protocols it conforms
+ * to, including protocols adopted by adopted protocols, by superclasses
+ * and by categories of the class.
+ */
+class ConformanceIndex {
+public:
+  /**
+   * @brief Protocol ID used for unknown protocols.
+   */
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+private:
+  size_t words = 0;                    /**< Number of 64-bit words per bitset. */
+  std::vector<const Protocol*> protocols; /**< Protocol of each ID. */
+  std::unordered_map<std::string_view, uint32_t> lookup; /**< Protocol name to ID map. */
+  std::vector<uint64_t> protocolBits; /**< Conformance bitset of each protocol, row-major. */
+  std::vector<uint64_t> classBits;    /**< Conformance bitset of each hierarchy node, row-major. */
+
+  std::vector<uint32_t> categoryOffsets; /**< Start of each node's categories, plus a sentinel. */
+  std::vector<uint32_t> categories;      /**< Category indices, grouped by base class node. */
+
+  uint32_t intern(const Protocol& protocol);
+
+public:
+  /**
+   * @brief Build the conformance of all classes of an image.
+   *
+   * @param abi The parsed image.
+   * @param hierarchy The hierarchy of the image, its nodes are the rows of
+   *        the class bitsets.
+   * @return std::unique_ptr<ConformanceIndex> The new index.
+   */
+  static std::unique_ptr<ConformanceIndex> build(const ABIObjectiveC& abi,
+                                                 const HierarchyIndex& hierarchy);
+
+  /**
+   * @brief Get the ID of a protocol.
+   *
+   * @param name The name of the protocol.
+   * @return uint32_t The ID or NONE if no class or protocol adopts it.
+   */
+  uint32_t find(std::string_view name) const;
+
+  /**
+   * @brief Check whether a hierarchy node conforms to a protocol.
+   *
+   * @param node The node of the class.
+   * @param protocol The ID of the protocol.
+   * @return bool True if the class (transitively) adopts the protocol.
+   */
+  inline bool conformsTo(uint32_t node, uint32_t protocol) const {
+    return protocol < protocols.size() && node < getClassCount() &&
+           (classBits[node * words + protocol / 64] >> (protocol % 64)) & 1;
+  }
+
+  /**
+   * @brief Check whether a protocol (transitively) adopts another one.
+   *
+   * A protocol conforms to itself.
+   *
+   * @param id The ID of the protocol.
+   * @param protocol The ID of the possibly adopted protocol.
+   * @return bool True if the protocol conforms to the other protocol.
+   */
+  inline bool protocolConformsTo(uint32_t id, uint32_t protocol) const {
+    return protocol < protocols.size() && id < protocols.size() &&
+           (protocolBits[id * words + protocol / 64] >> (protocol % 64)) & 1;
+  }
+
+  /**
+   * @brief Get all classes conforming to a protocol.
+   *
+   * @param protocol The ID of the protocol.
+   * @return std::vector<uint32_t> The hierarchy nodes of all conforming
+   *         classes, in ascending order.
+   */
+  std::vector<uint32_t> conformingClasses(uint32_t protocol) const;
+
+  /**
+   * @brief Get the categories extending a class.
+   *
+   * @param node The hierarchy node of the class.
+   * @return HierarchyIndex::Range Positions in getCategories(), empty if
+   *         the node is invalid.
+   */
+  inline HierarchyIndex::Range categoriesOf(uint32_t node) const {
+    return node + 1 < categoryOffsets.size()
+               ? HierarchyIndex::Range{categoryOffsets[node], categoryOffsets[node + 1]}
+               : HierarchyIndex::Range{0, 0};
+  }
+
+  /**
+   * @brief Get the number of distinct protocols.
+   *
+   * @return size_t The number of protocol IDs.
+   */
+  inline size_t size() const { return protocols.size(); }
+
+  /**
+   * @brief Get the number of rows of the class bitsets.
+   *
+   * @return size_t The number of hierarchy nodes.
+   */
+  inline size_t getClassCount() const { return categoryOffsets.empty() ? 0 : categoryOffsets.size() - 1; }
+
+  /**
+   * @brief Get the number of 64-bit words of each bitset.
+   *
+   * @return size_t The row width of all bitsets.
+   */
+  inline size_t getWordCount() const { return words; }
+
+  inline const Protocol* getProtocol(uint32_t id) const { return protocols[id]; }
+  inline const uint64_t* getClassBits(uint32_t node) const { return &classBits[node * words]; }
+  inline const uint64_t* getProtocolBits(uint32_t id) const { return &protocolBits[id * words]; }
+
+  /**
+   * @brief Get the category indices grouped by base class.
+   *
+   * @return const std::vector<uint32_t>& Indices into ABIObjectiveC::getCategories().
+   */
+  inline const std::vector<uint32_t>& getCategories() const { return categories; }
+};
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_CONFORMANCE_INDEX_H__
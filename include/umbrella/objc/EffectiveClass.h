@@ -0,0 +1,117 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_EFFECTIVE_CLASS_H__)
+#define __UMBRELLA_OBJC_EFFECTIVE_CLASS_H__
+
+#include <vector>
+
+#include "umbrella/visibility.h"
+
+#include "umbrella/ObjC/Category.h"
+#include "umbrella/ObjC/Class.h"
+#include "umbrella/ObjC/Method.h"
+#include "umbrella/ObjC/Property.h"
+#include "umbrella/ObjC/Protocol.h"
+#include "umbrella/iterators.h"
+
+namespace umbrella {
+namespace objc {
+
+/**
+ * @brief A class as seen by the runtime after its categories are attached.
+ *
+ * Lists follow the runtime attach order: the members of the category
+ * loaded last come first and the members of the class itself come last.
+ * Hence, the first method with a given selector is the one that is called.
+ */
+class EffectiveClass {
+public:
+  using MethodList = std::vector<Method*>;
+  using PropertyList = std::vector<Property*>;
+  using ProtocolList = std::vector<Protocol*>;
+  using CategoryList = std::vector<Category*>;
+
+  using it_methods = LIEF::const_ref_iterator<const MethodList&, Method*>;
+  using it_properties = LIEF::const_ref_iterator<const PropertyList&, Property*>;
+  using it_protocols = LIEF::const_ref_iterator<const ProtocolList&, Protocol*>;
+  using it_categories = LIEF::const_ref_iterator<const CategoryList&, Category*>;
+
+private:
+  const Class* cls = nullptr; /**< The extended class. */
+  CategoryList categories;    /**< Categories of the class, in attach order. */
+  MethodList methods;         /**< Instance methods of categories and the class. */
+  MethodList classMethods;    /**< Class methods of categories and the metaclass. */
+  PropertyList properties;    /**< Properties of categories and the class. */
+  ProtocolList protocols;     /**< Protocols adopted by categories and the class. */
+
+public:
+  /**
+   * @brief Merge categories into a class.
+   *
+   * @param cls The class.
+   * @param categories The categories of the class, in image (load) order.
+   * @return EffectiveClass The merged view.
+   */
+  static EffectiveClass merge(const Class& cls, const std::vector<const Category*>& categories);
+
+  /**
+   * @brief Get the extended class.
+   *
+   * @return const Class* The class itself.
+   */
+  inline const Class* getClass() const { return cls; }
+
+  /**
+   * @brief Get an iterator to the attached categories, last loaded first.
+   *
+   * @return it_categories An iterator to the categories.
+   */
+  inline it_categories getCategories() const { return categories; }
+
+  /**
+   * @brief Get an iterator to all instance methods.
+   *
+   * @return it_methods An iterator to the instance methods.
+   */
+  inline it_methods getMethods() const { return methods; }
+
+  /**
+   * @brief Get an iterator to all class methods.
+   *
+   * @return it_methods An iterator to the class methods.
+   */
+  inline it_methods getClassMethods() const { return classMethods; }
+
+  /**
+   * @brief Get an iterator to all instance properties.
+   *
+   * @return it_properties An iterator to the properties.
+   */
+  inline it_properties getProperties() const { return properties; }
+
+  /**
+   * @brief Get an iterator to all directly adopted protocols, without
+   *        duplicates.
+   *
+   * @return it_protocols An iterator to the protocols.
+   */
+  inline it_protocols getProtocols() const { return protocols; }
+};
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_EFFECTIVE_CLASS_H__
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_HIERARCHY_INDEX_H__)
+#define __UMBRELLA_OBJC_HIERARCHY_INDEX_H__
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+class ABIObjectiveC;
+class Class;
+
+/**
+ * @brief Precomputed class hierarchy of an image.
+ *
+ * Every class of the image, every base class of its categories and every
+ * superclass reachable from them (including imported placeholders) is a
+ * node. Nodes are numbered in
+ * depth-first pre-order, so the subclasses of a node occupy the
+ * contiguous range of nodes (node, getEnd(node)). Hence, subclass tests
+ * are a single interval check.
+ */
+class HierarchyIndex {
+public:
+  /**
+   * @brief Node number used for missing nodes (e.g. the parent of a root).
+   */
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  /**
+   * @brief Range of nodes [begin, end).
+   */
+  struct Range {
+    uint32_t begin; /**< First node of the range. */
+    uint32_t end;   /**< One past the last node of the range. */
+
+    inline uint32_t size() const { return end - begin; }
+    inline bool empty() const { return begin == end; }
+  };
+
+private:
+  std::vector<const Class*> classes; /**< Class of each node, in pre-order. */
+  std::vector<uint32_t> parents;     /**< Superclass node of each node, or NONE. */
+  std::vector<uint32_t> depths;      /**< Number of superclasses of each node. */
+  std::vector<uint32_t> ends;        /**< One past the last node of each subtree. */
+  std::vector<uint32_t> childOffsets; /**< Start of each node's children, plus a sentinel. */
+  std::vector<uint32_t> children;     /**< Direct subclasses, grouped by node. */
+  std::unordered_map<const Class*, uint32_t> lookup; /**< Class to node lookup map. */
+
+public:
+  /**
+   * @brief Build the hierarchy of all classes of an image.
+   *
+   * Superclass cycles (only present in malformed binaries) are broken at
+   * the class that was visited first.
+   *
+   * @param abi The parsed image.
+   * @return std::unique_ptr<HierarchyIndex> The new index.
+   */
+  static std::unique_ptr<HierarchyIndex> build(const ABIObjectiveC& abi);
+
+  /**
+   * @brief Get the node of a class.
+   *
+   * @param cls The class, e.g. from ABIObjectiveC::getClasses().
+   * @return uint32_t The node of the class or NONE if it is not part of the
+   *         hierarchy (e.g. a metaclass).
+   */
+  uint32_t find(const Class* cls) const;
+
+  /**
+   * @brief Check whether a node is a (transitive) subclass of another one.
+   *
+   * Like -[NSObject isSubclassOfClass:], a node is a subclass of itself.
+   *
+   * @param node The node to check.
+   * @param base The node of the possible superclass.
+   * @return bool True if node is base or one of its subclasses.
+   */
+  inline bool isSubclassOf(uint32_t node, uint32_t base) const {
+    return node < size() && base < size() && node >= base && node < ends[base];
+  }
+
+  /**
+   * @brief Check whether a class is a (transitive) subclass of another one.
+   *
+   * @param cls The class to check.
+   * @param base The possible superclass.
+   * @return bool True if cls is base or one of its subclasses.
+   */
+  inline bool isSubclassOf(const Class* cls, const Class* base) const {
+    return isSubclassOf(find(cls), find(base));
+  }
+
+  /**
+   * @brief Get all (transitive) subclasses of a node.
+   *
+   * @param node The node.
+   * @return Range The nodes of all subclasses, empty if the node is invalid.
+   */
+  inline Range subclassesOf(uint32_t node) const {
+    return node < size() ? Range{node + 1, ends[node]} : Range{0, 0};
+  }
+
+  /**
+   * @brief Get the direct subclasses of a node.
+   *
+   * @param node The node.
+   * @return Range Positions in getChildren(), empty if the node is invalid.
+   */
+  inline Range childrenOf(uint32_t node) const {
+    return node < size() ? Range{childOffsets[node], childOffsets[node + 1]} : Range{0, 0};
+  }
+
+  /**
+   * @brief Get the number of nodes.
+   *
+   * @return size_t The number of classes in the hierarchy.
+   */
+  inline size_t size() const { return classes.size(); }
+
+  inline const Class* getClass(uint32_t node) const { return classes[node]; }
+  inline uint32_t getParent(uint32_t node) const { return parents[node]; }
+  inline uint32_t getDepth(uint32_t node) const { return depths[node]; }
+  inline uint32_t getEnd(uint32_t node) const { return ends[node]; }
+
+  inline const std::vector<const Class*>& getClasses() const { return classes; }
+  inline const std::vector<uint32_t>& getChildren() const { return children; }
+};
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_HIERARCHY_INDEX_H__
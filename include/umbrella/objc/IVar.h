@@ -19,9 +19,11 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "umbrella/visibility.h"
 
+#include "umbrella/ObjC/TypeCache.h"
 #include "umbrella/ObjC/TypeEncoding.h"
 #include "umbrella/ObjC/Types.h"
 #include "umbrella/runtime.h"
@@ -39,8 +41,8 @@ public:
   friend class ABIObjectiveC; /**< Allowing ABIObjectiveC class to access private members. */
 
 private:
-  std::string name;     /**< The name of the instance variable. */
-  std::string typeName; /**< The mangled type name of the instance variable. */
+  std::string_view name;     /**< The name of the instance variable. */
+  std::string_view typeName; /**< The mangled type name of the instance variable. */
 
   uintptr_t alignment;  /**< The alignment of the instance variable. */
   uintptr_t size;       /**< The size of the instance variable. */
@@ -50,9 +52,9 @@ public:
    * @brief Static function to parse an instance variable from ABIObjectiveC.
    *
    * @param abi Reference to the ABIObjectiveC object.
-   * @return std::shared_ptr<IVar> A shared pointer to the parsed IVar object.
+   * @return IVar* The parsed instance variable, owned by the arena of the ABI.
    */
-  static std::shared_ptr<IVar> parse(ABIObjectiveC& abi);
+  static IVar* parse(ABIObjectiveC& abi);
 
 public:
   /**
@@ -64,16 +66,16 @@ public:
   /**
    * @brief Get the name of the instance variable.
    *
-   * @return const std::string& The name of the instance variable.
+   * @return std::string_view The name of the instance variable.
    */
-  const std::string& getName() const { return name; }
+  std::string_view getName() const { return name; }
 
   /**
    * @brief Get the mangled type name of the instance variable.
    *
-   * @return const std::string& The mangled type name.
+   * @return std::string_view The mangled type name.
    */
-  const std::string& getMangledTypeName() const { return typeName; }
+  std::string_view getMangledTypeName() const { return typeName; }
 
   /**
    * @brief Get the alignment requirement of the instance variable.
@@ -95,8 +97,7 @@ public:
    * @return std::string The decoded type name.
    */
   std::string getTypeName() const {
-    const TypeNode& node = *umbrella::objc::typedesc(getMangledTypeName());
-    return umbrella::objc::decode(node);
+    return TypeCache::global().decode(getMangledTypeName());
   }
 
   /**
@@ -104,7 +105,18 @@ public:
    *
    * @return std::string An Objective-C source code snippet representing the declaration.
    */
-  std::string getDeclaration() const;
+  inline std::string getDeclaration() const {
+    std::string result;
+    appendDeclaration(result);
+    return result;
+  }
+
+  /**
+   * @brief Append the declaration of this IVar to an existing buffer.
+   *
+   * @param _Out The buffer, may be reused for many declarations.
+   */
+  void appendDeclaration(std::string& _Out) const;
 };
 
 } // namespace objc
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_IMPLEMENTATION_INDEX_H__)
+#define __UMBRELLA_OBJC_IMPLEMENTATION_INDEX_H__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "umbrella/ObjC/MethodTable.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+/**
+ * @brief Sorted table of method implementation addresses, used to map code
+ *        addresses back to methods (e.g. to symbolicate stripped frames).
+ *
+ * Every address belongs to the method with the closest implementation
+ * address at or below it. Method sizes are unknown, hence each method
+ * extends up to the next implementation, the last one up to the end of the
+ * code section.
+ */
+class ImplementationIndex {
+private:
+  std::vector<uintptr_t> addresses; /**< Distinct implementation addresses, sorted. */
+  std::vector<uint32_t> rows;       /**< Method table row of each address. */
+  uintptr_t end{0};                 /**< End of the code containing the last method. */
+
+public:
+  /**
+   * @brief Build the index from the implementations of a method table.
+   *
+   * Methods without an implementation (e.g. of protocols) are skipped. If
+   * several methods share an implementation, the first row is used.
+   *
+   * @param table The method table of the image.
+   * @param textEnd The end address of the __text section, 0 if it is
+   *        unknown. Then, the last method ends right after its first byte.
+   * @return std::unique_ptr<ImplementationIndex> The new index.
+   */
+  static std::unique_ptr<ImplementationIndex> build(const MethodTable& table, uintptr_t textEnd);
+
+  /**
+   * @brief Find the method enclosing an address.
+   *
+   * @param address The code address.
+   * @param row Receives the method table row.
+   * @return bool True if the address lies between the first implementation
+   *         and the end of the code; otherwise, false.
+   */
+  bool find(uintptr_t address, uint32_t& row) const;
+
+  /**
+   * @brief Get the sorted implementation addresses.
+   *
+   * @return const std::vector<uintptr_t>& The addresses.
+   */
+  inline const std::vector<uintptr_t>& getAddresses() const { return addresses; }
+
+  /**
+   * @brief Get the number of distinct implementation addresses.
+   *
+   * @return size_t The number of entries.
+   */
+  inline size_t size() const { return addresses.size(); }
+
+  /**
+   * @brief Get the end of the last method.
+   *
+   * @return uintptr_t One past the highest address that resolves to a method.
+   */
+  inline uintptr_t getEnd() const { return end; }
+};
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_IMPLEMENTATION_INDEX_H__
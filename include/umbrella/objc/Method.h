@@ -18,7 +18,9 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
+#include "umbrella/ObjC/TypeCache.h"
 #include "umbrella/ObjC/TypeEncoding.h"
 #include "umbrella/ObjC/Types.h"
 #include "umbrella/runtime.h"
@@ -40,10 +42,10 @@ private:
     int32_t relImpl;   /**< The relative implementation address for small methods. */
   };
 
-  std::string name;      /**< The name of the method (selector string). */
-  std::string signature; /**< The encoded signature of the method. */
-  bool classMethod;      /**< Indicates whether this method is a class method. */
-  bool relativeMethod;   /**< Indicates whether the raw method is a small method. */
+  std::string_view name;      /**< The name of the method (selector string). */
+  std::string_view signature; /**< The encoded signature of the method. */
+  bool classMethod;           /**< Indicates whether this method is a class method. */
+  bool relativeMethod;        /**< Indicates whether the raw method is a small method. */
 
 public:
   /**
@@ -52,24 +54,24 @@ public:
    * @param abi Reference to the ABIObjectiveC object.
    * @param isSmall Flag indicating whether the method is a small method.
    * @param isClassMethod Flag indicating whether the method is a class method.
-   * @return std::shared_ptr<Method> A shared pointer to the parsed Method object.
+   * @return Method* The parsed method, owned by the arena of the ABI.
    */
-  static std::shared_ptr<Method> parse(ABIObjectiveC& abi, bool isSmall, bool isClassMethod);
+  static Method* parse(ABIObjectiveC& abi, bool isSmall, bool isClassMethod);
 
 public:
   /**
    * @brief Get the name of the method.
    *
-   * @return const std::string& The name of the method (selector string).
+   * @return std::string_view The name of the method (selector string).
    */
-  const std::string& getName() const { return name; }
+  std::string_view getName() const { return name; }
 
   /**
    * @brief Get the encoded signature of the method.
    *
-   * @return const std::string& The encoded signature of the method.
+   * @return std::string_view The encoded signature of the method.
    */
-  const std::string& getSignature() const { return signature; }
+  std::string_view getSignature() const { return signature; }
 
   /**
    * @brief Get the absolute implementation address of the method.
@@ -102,9 +104,13 @@ public:
   /**
    * @brief Get the type description of the method's signature.
    *
+   * The description is shared through TypeCache::global().
+   *
    * @return std::shared_ptr<TypeNode> A shared pointer to the type description.
    */
-  inline std::shared_ptr<TypeNode> getTypeDesc() const { return typedesc(getSignature()); }
+  inline std::shared_ptr<TypeNode> getTypeDesc() const {
+    return TypeCache::global().typedesc(getSignature());
+  }
 
   /**
    * @brief Decode the signature of this method to get the human-readable signature.
@@ -112,7 +118,7 @@ public:
    * @return std::string The decoded method signature.
    */
   inline std::string decodeSignature() const {
-    return umbrella::objc::signature(getName(), getSignature());
+    return TypeCache::global().signature(getName(), getSignature());
   }
 
   /**
@@ -121,7 +127,18 @@ public:
    * @return std::string An Objective-C source code snippet representing the
    *         declaration of the method.
    */
-  std::string getDeclaration() const;
+  inline std::string getDeclaration() const {
+    std::string result;
+    appendDeclaration(result);
+    return result;
+  }
+
+  /**
+   * @brief Append the declaration of this method to an existing buffer.
+   *
+   * @param _Out The buffer, may be reused for many declarations.
+   */
+  void appendDeclaration(std::string& _Out) const;
 
   /**
    * @brief Default constructor for the Method class.
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_METHOD_TABLE_H__)
+#define __UMBRELLA_OBJC_METHOD_TABLE_H__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "umbrella/StringPool.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+class ABIObjectiveC;
+class Method;
+
+/**
+ * @brief Columnar (struct-of-arrays) view of all methods of an image.
+ *
+ * Row i of every column describes the same method. Methods are grouped by
+ * their owner: all classes in the order of ABIObjectiveC::getClasses(),
+ * followed by all categories and all protocols. The methods of an owner
+ * form a contiguous range of rows (see ofClass(), ofCategory() and
+ * ofProtocol()).
+ */
+class MethodTable {
+public:
+  /**
+   * @brief Kind of object a method is declared by.
+   */
+  enum OwnerKind : uint8_t {
+    CLASS = 0,    /**< The owner is an index into ABIObjectiveC::getClasses(). */
+    CATEGORY = 1, /**< The owner is an index into ABIObjectiveC::getCategories(). */
+    PROTOCOL = 2, /**< The owner is an index into ABIObjectiveC::getProtocols(). */
+  };
+
+  /**
+   * @brief Bits stored in the flags column.
+   */
+  enum Flags : uint8_t {
+    CLASS_METHOD = 1 << 0, /**< The method is a class method. */
+    SMALL_METHOD = 1 << 1, /**< The raw method is a small (relative) method. */
+    OPTIONAL = 1 << 2,     /**< The protocol method is optional. */
+  };
+
+  /**
+   * @brief Range of rows [begin, end) belonging to one owner.
+   */
+  struct Range {
+    uint32_t begin; /**< First row of the range. */
+    uint32_t end;   /**< One past the last row of the range. */
+
+    inline uint32_t size() const { return end - begin; }
+    inline bool empty() const { return begin == end; }
+  };
+
+private:
+  std::vector<uint8_t> ownerKinds;            /**< Kind of the declaring object. */
+  std::vector<uint32_t> owners;               /**< Index of the declaring object. */
+  std::vector<StringPool::Handle> selectors;  /**< Selector ID in the string pool. */
+  std::vector<StringPool::Handle> signatures; /**< Type encoding ID in the string pool. */
+  std::vector<uintptr_t> implementations;     /**< Resolved implementation address (or 0). */
+  std::vector<uint8_t> flags;                 /**< Combination of Flags. */
+  std::vector<const Method*> methods;         /**< The method object of each row. */
+
+  std::vector<Range> classRanges;    /**< Rows of each class (instance, then class methods). */
+  std::vector<Range> categoryRanges; /**< Rows of each category. */
+  std::vector<Range> protocolRanges; /**< Rows of each protocol. */
+
+  void add(const ABIObjectiveC& abi, StringPool& pool, const Method& method, OwnerKind kind,
+           uint32_t owner, uint8_t methodFlags);
+
+public:
+  /**
+   * @brief Build the table of all methods of an image.
+   *
+   * Lazily parsed members are decoded while building the table.
+   *
+   * @param abi The parsed image.
+   * @param pool The pool the strings of the image are interned in.
+   * @return std::unique_ptr<MethodTable> The new table.
+   */
+  static std::unique_ptr<MethodTable> build(const ABIObjectiveC& abi, StringPool& pool);
+
+  /**
+   * @brief Get the number of rows.
+   *
+   * @return size_t The number of methods in the image.
+   */
+  inline size_t size() const { return methods.size(); }
+
+  inline const std::vector<uint8_t>& getOwnerKinds() const { return ownerKinds; }
+  inline const std::vector<uint32_t>& getOwners() const { return owners; }
+  inline const std::vector<StringPool::Handle>& getSelectors() const { return selectors; }
+  inline const std::vector<StringPool::Handle>& getSignatures() const { return signatures; }
+  inline const std::vector<uintptr_t>& getImplementations() const { return implementations; }
+  inline const std::vector<uint8_t>& getFlags() const { return flags; }
+  inline const std::vector<const Method*>& getMethods() const { return methods; }
+
+  /**
+   * @brief Get the rows of a class, including the methods of its metaclass.
+   *
+   * @param index The index of the class in ABIObjectiveC::getClasses().
+   * @return Range The rows of the class, empty if the index is invalid.
+   */
+  Range ofClass(size_t index) const;
+
+  /**
+   * @brief Get the rows of a category.
+   *
+   * @param index The index of the category in ABIObjectiveC::getCategories().
+   * @return Range The rows of the category, empty if the index is invalid.
+   */
+  Range ofCategory(size_t index) const;
+
+  /**
+   * @brief Get the rows of a protocol.
+   *
+   * @param index The index of the protocol in ABIObjectiveC::getProtocols().
+   * @return Range The rows of the protocol, empty if the index is invalid.
+   */
+  Range ofProtocol(size_t index) const;
+};
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_METHOD_TABLE_H__
@@ -18,7 +18,9 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
+#include "umbrella/ObjC/TypeCache.h"
 #include "umbrella/ObjC/TypeEncoding.h"
 #include "umbrella/ObjC/Types.h"
 #include "umbrella/runtime.h"
@@ -34,17 +36,17 @@ class ABIObjectiveC;
  */
 class Property final : public InProcess {
 private:
-  std::string name;       /**< The name of the property. */
-  std::string attributes; /**< The attributes of the property. */
+  std::string_view name;       /**< The name of the property. */
+  std::string_view attributes; /**< The attributes of the property. */
 
 public:
   /**
    * @brief Static function to parse an Objective-C property.
    *
    * @param abi Reference to the ABIObjectiveC object.
-   * @return std::shared_ptr<Property> A shared pointer to the parsed Property object.
+   * @return Property* The parsed property, owned by the arena of the ABI.
    */
-  static std::shared_ptr<Property> parse(ABIObjectiveC& abi);
+  static Property* parse(ABIObjectiveC& abi);
 
 public:
   /**
@@ -56,16 +58,16 @@ public:
   /**
    * @brief Get the name of the property.
    *
-   * @return const std::string& The name of the property.
+   * @return std::string_view The name of the property.
    */
-  inline const std::string& getName() const { return name; }
+  inline std::string_view getName() const { return name; }
 
   /**
    * @brief Get the attributes of the property.
    *
-   * @return const std::string& The attributes of the property.
+   * @return std::string_view The attributes of the property.
    */
-  inline const std::string& getAttributes() const { return attributes; }
+  inline std::string_view getAttributes() const { return attributes; }
 
   /**
    * @brief Decode the attributes of this property into a fully representative
@@ -74,8 +76,7 @@ public:
    * @return std::string The decoded attributes as a string.
    */
   inline std::string decodeAttributes() const {
-    const TypeNode& node = *umbrella::objc::typedesc(getAttributes());
-    return umbrella::objc::decode(node);
+    return TypeCache::global().decode(getAttributes());
   }
 
   /**
@@ -84,7 +85,18 @@ public:
    * @return std::string An Objective-C source code snippet representing the
    *         declaration of the property.
    */
-  std::string getDeclaration() const;
+  inline std::string getDeclaration() const {
+    std::string result;
+    appendDeclaration(result);
+    return result;
+  }
+
+  /**
+   * @brief Append the declaration of this property to an existing buffer.
+   *
+   * @param _Out The buffer, may be reused for many declarations.
+   */
+  void appendDeclaration(std::string& _Out) const;
 };
 
 } // namespace objc
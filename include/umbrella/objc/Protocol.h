@@ -18,13 +18,16 @@
 
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "umbrella/visibility.h"
 
 #include "umbrella/ObjC/Method.h"
 #include "umbrella/ObjC/Property.h"
+#include "umbrella/ObjC/Types.h"
 #include "umbrella/iterators.h"
 
 namespace umbrella {
@@ -37,8 +40,10 @@ class ABIObjectiveC;
  */
 class Protocol final : public InProcess {
 public:
-  using MethodList = std::vector<std::shared_ptr<objc::Method>>;
-  using PropertyList = std::vector<std::shared_ptr<Property>>;
+  friend class ABIObjectiveC; /**< Allowing ABIObjectiveC class to access private members. */
+
+  using MethodList = std::vector<Method*>;
+  using PropertyList = std::vector<Property*>;
   using ProtocolList = std::vector<std::shared_ptr<Protocol>>;
 
   using it_methods = LIEF::const_ref_iterator<const MethodList&, Method*>;
@@ -46,8 +51,8 @@ public:
   using it_protocols = LIEF::const_ref_iterator<const ProtocolList&, Protocol*>;
 
 private:
-  std::string name; /**< The name of the protocol. */
-  uint32_t flags;   /**< Flags associated with the protocol. */
+  std::string_view name; /**< The name of the protocol. */
+  uint32_t flags;        /**< Flags associated with the protocol. */
 
   MethodList requiredInstanceMethods; /**< List of required instance methods for the protocol. */
   MethodList requiredClassMethods;    /**< List of required class methods for the protocol. */
@@ -56,6 +61,9 @@ private:
   PropertyList instanceProperties;    /**< List of properties associated with the protocol. */
   ProtocolList protocols;             /**< List of protocols this protocol conforms to. */
 
+  ABIObjectiveC* lazyABI{nullptr};    /**< ABI used to decode members on first access. */
+  mutable std::once_flag membersOnce; /**< Guards the lazy decoding of members. */
+
 public:
   /**
    * @brief Static function to parse an Objective-C protocol.
@@ -65,6 +73,21 @@ public:
    */
   static std::shared_ptr<Protocol> parse(ABIObjectiveC& abi);
 
+private:
+  /**
+   * @brief Parse methods, properties and adopted protocols.
+   *
+   * @param abi Reference to the ABIObjectiveC object.
+   * @param raw The raw protocol_t.
+   */
+  void parseMembers(ABIObjectiveC& abi, const protocol_t& raw);
+
+  /**
+   * @brief Decode all members if they were not decoded while parsing.
+   */
+  void materialize() const;
+
+public:
   /**
    * @brief Default constructor for the Protocol class.
    * Initializes the address to 0.
@@ -74,51 +97,69 @@ public:
   /**
    * @brief Get the name of the protocol.
    *
-   * @return const std::string& The name of the protocol.
+   * @return std::string_view The name of the protocol.
    */
-  inline const std::string& getName() const { return name; }
+  inline std::string_view getName() const { return name; }
 
   /**
    * @brief Get an iterator to the required instance methods of the protocol.
    *
    * @return it_methods An iterator to the required instance methods.
    */
-  inline it_methods getRequiredInstanceMethods() const { return requiredInstanceMethods; }
+  inline it_methods getRequiredInstanceMethods() const {
+    materialize();
+    return requiredInstanceMethods;
+  }
 
   /**
    * @brief Get an iterator to the optional instance methods of the protocol.
    *
    * @return it_methods An iterator to the optional instance methods.
    */
-  inline it_methods getOptionalInstanceMethods() const { return optionalInstanceMethods; }
+  inline it_methods getOptionalInstanceMethods() const {
+    materialize();
+    return optionalInstanceMethods;
+  }
 
   /**
    * @brief Get an iterator to the required class methods of the protocol.
    *
    * @return it_methods An iterator to the required class methods.
    */
-  inline it_methods getRequiredClassMethods() const { return requiredClassMethods; }
+  inline it_methods getRequiredClassMethods() const {
+    materialize();
+    return requiredClassMethods;
+  }
 
   /**
    * @brief Get an iterator to the optional class methods of the protocol.
    *
    * @return it_methods An iterator to the optional class methods.
    */
-  inline it_methods getOptionalClassMethods() const { return optionalClassMethods; }
+  inline it_methods getOptionalClassMethods() const {
+    materialize();
+    return optionalClassMethods;
+  }
 
   /**
    * @brief Get an iterator to the instance properties of the protocol.
    *
    * @return it_properties An iterator to the instance properties.
    */
-  inline it_properties getInstanceProperties() const { return instanceProperties; }
+  inline it_properties getInstanceProperties() const {
+    materialize();
+    return instanceProperties;
+  }
 
   /**
    * @brief Get an iterator to the protocols this protocol conforms to.
    *
    * @return it_protocols An iterator to the conforming protocols.
    */
-  inline it_protocols getProtocols() const { return protocols; }
+  inline it_protocols getProtocols() const {
+    materialize();
+    return protocols;
+  }
 
   /**
    * @brief Get the flags associated with the protocol.
@@ -133,7 +174,18 @@ public:
    * @return std::string An Objective-C source code snippet representing the
    *         declaration of the protocol.
    */
-  std::string getDeclaration() const;
+  inline std::string getDeclaration() const {
+    std::string result;
+    appendDeclaration(result);
+    return result;
+  }
+
+  /**
+   * @brief Append the declaration of this protocol to an existing buffer.
+   *
+   * @param _Out The buffer, may be reused for many declarations.
+   */
+  void appendDeclaration(std::string& _Out) const;
 
   // TODO: maybe support that:
   // friend std::ostream &operator<<(std::ostream &stream, Protocol &protocol) {
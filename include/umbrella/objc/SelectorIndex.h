@@ -0,0 +1,84 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_SELECTOR_INDEX_H__)
+#define __UMBRELLA_OBJC_SELECTOR_INDEX_H__
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "umbrella/ObjC/MethodTable.h"
+#include "umbrella/StringPool.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+/**
+ * @brief Reverse index from selectors to the methods implementing or
+ *        declaring them.
+ *
+ * The index is stored in compressed sparse row form: the rows of the
+ * method table are sorted by selector, and every selector maps to one
+ * contiguous range of them. This covers methods of classes, metaclasses,
+ * categories and protocols alike (see MethodTable::getOwnerKinds()).
+ */
+class SelectorIndex {
+private:
+  std::vector<uint32_t> rows;    /**< Method table rows grouped by selector. */
+  std::vector<uint32_t> offsets; /**< Start of each selector's group in rows. */
+
+  // Maps a selector handle to the position of its group in offsets.
+  std::unordered_map<StringPool::Handle, uint32_t> groups;
+
+public:
+  /**
+   * @brief Build the index over all methods of a method table.
+   *
+   * @param table The method table of the image.
+   * @return std::unique_ptr<SelectorIndex> The new index.
+   */
+  static std::unique_ptr<SelectorIndex> build(const MethodTable& table);
+
+  /**
+   * @brief Get the method table rows sharing a selector.
+   *
+   * @param selector The handle of the selector.
+   * @return MethodTable::Range A range of positions in getRows(), empty if
+   *         no method uses this selector.
+   */
+  MethodTable::Range find(StringPool::Handle selector) const;
+
+  /**
+   * @brief Get all method table rows, grouped by selector.
+   *
+   * @return const std::vector<uint32_t>& Rows of the method table.
+   */
+  inline const std::vector<uint32_t>& getRows() const { return rows; }
+
+  /**
+   * @brief Get the number of distinct selectors.
+   *
+   * @return size_t The number of selectors.
+   */
+  inline size_t size() const { return groups.size(); }
+};
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_SELECTOR_INDEX_H__
@@ -0,0 +1,158 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_TYPE_CACHE_H__)
+#define __UMBRELLA_OBJC_TYPE_CACHE_H__
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "umbrella/ObjC/TypeEncoding.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+/**
+ * @brief Bounded, thread-safe memo cache for typedesc(), decode() and
+ *        signature().
+ *
+ * Entries are keyed by the encoded string (plus the selector for
+ * signatures). The least recently used entry is dropped once the cache
+ * is full. Cached type descriptions are shared with all callers and must
+ * not be modified.
+ */
+class TypeCache {
+public:
+  /**
+   * @brief Default number of entries.
+   */
+  static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+  /**
+   * @brief Counters of a cache.
+   */
+  struct Stats {
+    uint64_t hits;   /**< Number of lookups answered from the cache. */
+    uint64_t misses; /**< Number of lookups that had to decode. */
+    size_t size;     /**< Number of entries. */
+    size_t capacity; /**< Maximum number of entries. */
+  };
+
+private:
+  struct Entry {
+    std::string key;                /**< Encoding, or selector and signature. */
+    std::shared_ptr<TypeNode> tree; /**< Parsed encoding (empty for signatures). */
+    std::string decoded;            /**< Decoded encoding or signature. */
+    bool hasDecoded{false};         /**< Whether decoded is set. */
+    bool hasTree{false};            /**< Whether tree is set, nullptr if malformed. */
+  };
+
+  std::list<Entry> entries; /**< All entries, most recently used first. */
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> lookup; /**< Key to entry map. */
+  size_t capacity;      /**< Maximum number of entries. */
+  uint64_t hits = 0;    /**< See Stats::hits. */
+  uint64_t misses = 0;  /**< See Stats::misses. */
+  mutable std::mutex mutex; /**< Guards all members. */
+
+  // Returns the entry of a key and marks it as used, the mutex must be held
+  Entry* find(std::string_view key);
+  // Inserts (or returns) the entry of a key, the mutex must be held
+  Entry& insert(std::string_view key);
+
+public:
+  /**
+   * @brief Constructor for TypeCache.
+   *
+   * @param _Capacity The maximum number of entries (at least one).
+   */
+  explicit TypeCache(size_t _Capacity = DEFAULT_CAPACITY);
+
+  TypeCache(const TypeCache&) = delete;
+  TypeCache& operator=(const TypeCache&) = delete;
+
+  /**
+   * @brief Cached version of objc::typedesc().
+   *
+   * @param _Encoded the raw type encoding.
+   * @return std::shared_ptr<TypeNode> The shared type description or nullptr
+   *         if the encoding is empty or malformed.
+   */
+  std::shared_ptr<TypeNode> typedesc(std::string_view _Encoded);
+
+  /**
+   * @brief Cached version of objc::decode(*objc::typedesc(_Encoded)).
+   *
+   * @param _Encoded the raw type encoding.
+   * @return std::string The decoded type, empty if the encoding is empty or
+   *         malformed.
+   */
+  std::string decode(std::string_view _Encoded);
+
+  /**
+   * @brief Cached version of objc::appendDecoded().
+   *
+   * @param _Encoded the raw type encoding.
+   * @param _Out the buffer the decoded type is appended to.
+   */
+  void appendDecoded(std::string_view _Encoded, std::string& _Out);
+
+  /**
+   * @brief Cached version of objc::signature().
+   *
+   * @param _Selector The method's selector string.
+   * @param _Signature The encoded signature.
+   * @return std::string The qualified signature as a string.
+   */
+  std::string signature(std::string_view _Selector, std::string_view _Signature);
+
+  /**
+   * @brief Cached version of objc::appendSignature().
+   *
+   * @param _Selector The method's selector string.
+   * @param _Signature The encoded signature.
+   * @param _Out the buffer the signature is appended to.
+   */
+  void appendSignature(std::string_view _Selector, std::string_view _Signature, std::string& _Out);
+
+  /**
+   * @brief Get the hit and miss counters.
+   *
+   * @return Stats The current counters.
+   */
+  Stats getStats() const;
+
+  /**
+   * @brief Remove all entries and reset the counters.
+   */
+  void clear();
+
+  /**
+   * @brief Get the process-wide cache used by Method, IVar and Property.
+   *
+   * @return TypeCache& The shared cache.
+   */
+  static TypeCache& global();
+};
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_TYPE_CACHE_H__
@@ -16,11 +16,13 @@
 #if !defined(__UMBRELLA_OBJC_TYPE_ENCODING_H__)
 #define __UMBRELLA_OBJC_TYPE_ENCODING_H__
 
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <type_traits>
-#include <unordered_map>
 #include <vector>
 
 #include "umbrella/iterators.h"
@@ -77,60 +79,208 @@ enum class MethodType {
   COMPLEX,
 };
 
+struct TypeTree;
+
 /**
  * @brief Struct to store mangled type information.
+ *
+ * Nodes are owned by their TypeTree. Parent and children are stored as
+ * indices into the tree and names refer to the encoded string (or to
+ * static type names), so a node never owns any memory.
  */
 struct TypeNode {
-  using Children = std::vector<std::shared_ptr<TypeNode>>;
-  using it_children = LIEF::const_ref_iterator<const Children&, TypeNode*>;
-
-  uint32_t type{0};                          /**< The internal Objective-C type. */
-  uint32_t size{0};                          /**< The size in bytes. */
-  uint32_t alignment{0};                     /**< Alignment in bytes. */
-  uint32_t dim{0};                           /**< Array dimensions. */
-  uint32_t stack_size{0};                    /**< Stack size. */
-  std::vector<std::string> attributes;       /**< Attributes used for properties. */
-  std::string name;                          /**< The node's name. */
-  std::shared_ptr<TypeNode> parent{nullptr}; /**< The parent node. */
-  Children children;                         /**< All children stored in a separate list. */
-
-  const TypeNode& operator[](size_t _Index) const {
-    // assert _Index
-    return *children[_Index];
-  }
+  using Children = std::vector<const TypeNode*>;
+  using it_children = LIEF::const_ref_iterator<Children, const TypeNode*>;
+
+  /**
+   * @brief Index used for missing nodes (e.g. the parent of the root).
+   */
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  uint32_t type{0};                 /**< The internal Objective-C type. */
+  uint32_t size{0};                 /**< The size in bytes. */
+  uint32_t alignment{0};            /**< Alignment in bytes. */
+  uint32_t dim{0};                  /**< Array dimensions. */
+  uint32_t stack_size{0};           /**< Stack size. */
+  std::string_view qualifiers;      /**< Encoded method type qualifiers (e.g. "rn"). */
+  std::string_view name;            /**< The node's name. */
+  uint32_t parent{NONE};            /**< Index of the parent node. */
+  uint32_t firstChild{0};           /**< Start of the children in TypeTree::links. */
+  uint32_t childCount{0};           /**< Number of children. */
+  const TypeTree* tree{nullptr};    /**< The tree owning this node. */
+
+  const TypeNode& operator[](size_t _Index) const;
 
   const Type getType() const { return (Type)type; }
   const AttributeType getAttributeType() const { return (AttributeType)type; }
-  it_children getChildren() const { return children; }
+  size_t getChildCount() const { return childCount; }
+  it_children getChildren() const;
+
+  /**
+   * @brief Get the parent node.
+   *
+   * @return const TypeNode* The parent or nullptr for the root node.
+   */
+  const TypeNode* getParent() const;
+
+  /**
+   * @brief Get the names of the method type qualifiers (e.g. "const").
+   *
+   * @return std::vector<std::string_view> The qualifiers, in encoded order.
+   */
+  std::vector<std::string_view> getAttributes() const;
 };
 
 /**
- * @brief Map of character representations to Type enum values.
+ * @brief Flat storage of all nodes of one parsed type encoding.
+ *
+ * All nodes live in a single vector, node 0 is the root. The children of
+ * a node form a contiguous block of indices in links.
  */
-static const std::unordered_map<char, Type> OBJC_NODE_TYPES{
-#define OBJC_TYPE(id, name, alignment, value) {id, Type::value},
-#include "umbrella/objc/TypeEncoding.def"
-#undef OBJC_TYPE
+struct TypeTree {
+  std::string encoded;          /**< Copy of the encoding, referenced by the node names. */
+  std::vector<TypeNode> nodes;  /**< All nodes, the root first. */
+  std::vector<uint32_t> links;  /**< Child indices, grouped by parent. */
+
+  TypeTree() = default;
+  TypeTree(const TypeTree&) = delete;
+  TypeTree& operator=(const TypeTree&) = delete;
+
+  inline const TypeNode& getRoot() const { return nodes[0]; }
 };
 
+inline const TypeNode& TypeNode::operator[](size_t _Index) const {
+  // assert _Index
+  return tree->nodes[tree->links[firstChild + _Index]];
+}
+
+inline const TypeNode* TypeNode::getParent() const {
+  return parent != NONE ? &tree->nodes[parent] : nullptr;
+}
+
+inline TypeNode::it_children TypeNode::getChildren() const {
+  Children children;
+  children.reserve(childCount);
+  for (uint32_t i = 0; i < childCount; i++) {
+    children.push_back(&(*this)[i]);
+  }
+  return children;
+}
+
 /**
- * @brief Map of Type enum values to type names.
+ * @brief Classification of a single character of a type encoding.
  */
-static const std::unordered_map<uint32_t, std::string> OBJC_NODE_TYPE_NAMES{
-#define OBJC_TYPE(id, name, alignment, value) {(uint32_t)Type::value, name},
+struct TypeCode {
+  uint8_t type{0};           /**< Type of a simple type character, 0 otherwise. */
+  uint8_t alignment{0};      /**< Size and alignment of the simple type. */
+  uint8_t qualifier{0};      /**< MethodType + 1 of a qualifier character, 0 otherwise. */
+  const char* name{nullptr}; /**< Name of the simple type or qualifier. */
+
+  constexpr bool isSimpleType() const { return type != 0; }
+  constexpr bool isQualifier() const { return qualifier != 0; }
+};
+
+namespace detail {
+
+constexpr std::array<TypeCode, 256> makeTypeCodes() {
+  std::array<TypeCode, 256> codes{};
+#define OBJC_TYPE(id, name_, alignment_, value)                                                   \
+  codes[(unsigned char)id] = {(uint8_t)Type::value, alignment_, 0, name_};
+#define METHOD_TYPE(id, name_, value)                                                             \
+  codes[(unsigned char)id] = {0, 0, (uint8_t)((uint8_t)MethodType::value + 1), name_};
 #include "umbrella/objc/TypeEncoding.def"
+#undef METHOD_TYPE
 #undef OBJC_TYPE
+  return codes;
+}
+
+constexpr std::array<const char*, 256> makeTypeNames() {
+  std::array<const char*, 256> names{};
+#define OBJC_TYPE(id, name_, alignment_, value) names[(uint8_t)Type::value] = name_;
+#include "umbrella/objc/TypeEncoding.def"
+#undef OBJC_TYPE
+  return names;
+}
+
+} // namespace detail
+
+/**
+ * @brief Table of all 256 characters, generated from TypeEncoding.def.
+ */
+inline constexpr std::array<TypeCode, 256> OBJC_TYPE_CODES = detail::makeTypeCodes();
+
+/**
+ * @brief Names of all simple types, indexed by their Type value.
+ */
+inline constexpr std::array<const char*, 256> OBJC_TYPE_NAMES = detail::makeTypeNames();
+
+/**
+ * @brief Get the classification of a character.
+ *
+ * @param _Char the character of the type encoding.
+ * @return const TypeCode& The entry in OBJC_TYPE_CODES.
+ */
+constexpr const TypeCode& typeCode(char _Char) { return OBJC_TYPE_CODES[(unsigned char)_Char]; }
+
+/**
+ * @brief Check whether a node type is a simple (named) type.
+ *
+ * @param _Type the type of the node.
+ * @return bool True if the type has a fixed name in OBJC_TYPE_NAMES.
+ */
+constexpr bool isSimpleType(uint32_t _Type) {
+  return _Type < OBJC_TYPE_NAMES.size() && OBJC_TYPE_NAMES[_Type] != nullptr;
+}
+
+static_assert(typeCode('i').type == (uint8_t)Type::INT, "type table out of sync");
+static_assert(typeCode('r').qualifier == (uint8_t)MethodType::CONST + 1, "qualifier table out of sync");
+
+/**
+ * @brief Maximum nesting depth of a type encoding, deeper encodings are
+ *        rejected with TypeError::TOO_DEEP.
+ */
+inline constexpr uint32_t TYPE_MAX_DEPTH = 512;
+
+/**
+ * @brief Reasons a type encoding could not be parsed.
+ */
+enum class TypeError : uint32_t {
+  NONE = 0,             /**< The encoding was parsed successfully. */
+  UNEXPECTED_END = 1,   /**< The encoding is empty or truncated. */
+  TOO_DEEP = 2,         /**< The encoding exceeds TYPE_MAX_DEPTH. */
+  NUMBER_TOO_LARGE = 3, /**< A size or offset does not fit into 32 bits. */
 };
 
 /**
- * @brief Map of character representations to MethodType enum values.
+ * @brief Result of parseEncoding().
  */
-static const std::unordered_map<char, MethodType> OBJC_METHOD_TYPES{
-#define METHOD_TYPE(id, name, value) {id, MethodType::value},
-#include "umbrella/objc/TypeEncoding.def"
-#undef METHOD_TYPE
+struct TypeResult {
+  std::shared_ptr<TypeNode> node;     /**< The root node, nullptr on error. */
+  TypeError error{TypeError::NONE};   /**< The first error encountered. */
+  size_t offset{0};                   /**< Position of the error in the encoding. */
+
+  inline bool ok() const { return error == TypeError::NONE; }
 };
 
+/**
+ * @brief Parses a type encoding without throwing.
+ *
+ * Every read is checked against the end of the encoding, hence malformed
+ * or truncated input fails after at most one pass over it.
+ *
+ * @param _Encoded the raw type encoding.
+ * @return TypeResult The root node or the reason of the failure.
+ */
+TypeResult parseEncoding(std::string_view _Encoded);
+
+/**
+ * @brief Get a readable message for a parser error.
+ *
+ * @param _Error the error.
+ * @return const char* The static message.
+ */
+const char* describe(TypeError _Error);
+
 /**
  * @brief Creates a type description based on the given signature.
  *
@@ -138,8 +288,12 @@ static const std::unordered_map<char, MethodType> OBJC_METHOD_TYPES{
  * encodings. It is recommended to NOT use any other functions to create a type
  * description besides this one.
  *
+ * The returned pointer refers to the root node and shares ownership of
+ * the whole TypeTree, which is released together with the last reference.
+ *
  * @param _Encoded the raw type encoding.
- * @return std::shared_ptr<TypeNode> A shared pointer to the generated TypeNode.
+ * @return std::shared_ptr<TypeNode> A shared pointer to the generated TypeNode,
+ *         nullptr if the encoding is empty or malformed (see parseEncoding()).
  */
 std::shared_ptr<TypeNode> typedesc(const std::string& _Encoded);
 
@@ -151,6 +305,14 @@ std::shared_ptr<TypeNode> typedesc(const std::string& _Encoded);
  */
 std::string decode(const TypeNode& _Node);
 
+/**
+ * @brief Decodes a type description into an existing buffer.
+ *
+ * @param _Node the type description node.
+ * @param _Out the buffer the decoded type is appended to.
+ */
+void appendDecoded(const TypeNode& _Node, std::string& _Out);
+
 /**
  * @brief Generates a fully qualified method signature.
  *
@@ -160,6 +322,16 @@ std::string decode(const TypeNode& _Node);
  */
 std::string signature(const std::string& _Selector, const std::string& _Signature);
 
+/**
+ * @brief Generates a fully qualified method signature into an existing
+ *        buffer.
+ *
+ * @param _Selector The method's selector string.
+ * @param _Signature The encoded signature.
+ * @param _Out the buffer the signature is appended to.
+ */
+void appendSignature(std::string_view _Selector, std::string_view _Signature, std::string& _Out);
+
 // TODO:
 // void dumpTree(const TypeNode& _Node);
 
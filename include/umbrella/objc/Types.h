@@ -167,6 +167,12 @@ public:
    * @return uintptr_t The class_ro pointer.
    */
   uintptr_t class_ro() const { return bits & MASK; };
+
+  /**
+   * @brief Get the raw bits, which may still have to be fixed up.
+   * @return uintptr_t The raw bits.
+   */
+  uintptr_t value() const { return bits; };
 };
 
 /**
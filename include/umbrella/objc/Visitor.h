@@ -0,0 +1,155 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_OBJC_VISITOR_H__)
+#define __UMBRELLA_OBJC_VISITOR_H__
+
+#include <memory>
+#include <string>
+
+#include "umbrella/runtime.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+/**
+ * @brief Record emitted for every class in __objc_classlist.
+ */
+struct ClassRecord {
+  uintptr_t address;              /**< Address of the class_t struct. */
+  uintptr_t superClass;           /**< Fixed-up address of the superclass (0 if none). */
+  uintptr_t metaClass;            /**< Fixed-up address of the metaclass (0 if none). */
+  uint32_t flags;                 /**< Flags stored in class_ro_t. */
+  std::string name;               /**< The name of the class. */
+  std::string importedSuperClass; /**< Symbol the superclass is bound to (empty if local). */
+};
+
+/**
+ * @brief Record emitted for every protocol in __objc_protolist.
+ */
+struct ProtocolRecord {
+  uintptr_t address; /**< Address of the protocol_t struct. */
+  uint32_t flags;    /**< Flags associated with the protocol. */
+  std::string name;  /**< The name of the protocol. */
+};
+
+/**
+ * @brief Record emitted for every category in __objc_catlist.
+ */
+struct CategoryRecord {
+  uintptr_t address;             /**< Address of the category_t struct. */
+  uintptr_t baseClass;           /**< Fixed-up address of the extended class (0 if unknown). */
+  std::string name;              /**< The name of the category. */
+  std::string importedBaseClass; /**< Symbol the extended class is bound to (empty if local). */
+};
+
+/**
+ * @brief Record emitted for every method of a class, protocol or category.
+ */
+struct MethodRecord {
+  uintptr_t owner;       /**< Address of the declaring class, protocol or category. */
+  uintptr_t address;     /**< Address of the raw method struct. */
+  uintptr_t impl;        /**< Absolute address of the implementation (0 if none). */
+  bool classMethod;      /**< Indicates whether this method is a class method. */
+  bool optional;         /**< Indicates an optional protocol method. */
+  std::string name;      /**< The name of the method (selector string). */
+  std::string signature; /**< The encoded signature of the method. */
+};
+
+/**
+ * @brief Record emitted for every instance variable of a class.
+ */
+struct IVarRecord {
+  uintptr_t owner;      /**< Address of the declaring class. */
+  uintptr_t address;    /**< Address of the ivar_t struct. */
+  uintptr_t alignment;  /**< Alignment of the ivar. */
+  uintptr_t size;       /**< Size of the ivar. */
+  std::string name;     /**< The name of the ivar. */
+  std::string typeName; /**< The encoded type of the ivar. */
+};
+
+/**
+ * @brief Record emitted for every property of a class, protocol or category.
+ */
+struct PropertyRecord {
+  uintptr_t owner;        /**< Address of the declaring class, protocol or category. */
+  uintptr_t address;      /**< Address of the property_t struct. */
+  bool classProperty;     /**< Indicates a property declared by the metaclass. */
+  std::string name;       /**< The name of the property. */
+  std::string attributes; /**< The encoded attributes of the property. */
+};
+
+/**
+ * @brief Record emitted for every protocol adopted by a class, protocol or category.
+ */
+struct ConformanceRecord {
+  uintptr_t owner;    /**< Address of the adopting class, protocol or category. */
+  uintptr_t protocol; /**< Fixed-up address of the adopted protocol_t. */
+  std::string name;   /**< The name of the adopted protocol. */
+};
+
+/**
+ * @brief Callbacks receiving Objective-C metadata while it is walked.
+ *
+ * In contrast to ABIObjectiveC::parse, no object graph will be built: each
+ * record is passed to the visitor and discarded afterwards. Records are
+ * reused between calls, so copy everything that must outlive a callback.
+ *
+ * Members are reported directly after their owner. Returning false from
+ * onClass, onProtocol or onCategory skips the members of that object.
+ */
+class Visitor {
+public:
+  virtual ~Visitor() = default;
+
+  virtual bool onClass(const ClassRecord& record) { return true; }
+  virtual bool onProtocol(const ProtocolRecord& record) { return true; }
+  virtual bool onCategory(const CategoryRecord& record) { return true; }
+
+  virtual void onMethod(const MethodRecord& record) {}
+  virtual void onIVar(const IVarRecord& record) {}
+  virtual void onProperty(const PropertyRecord& record) {}
+  virtual void onConformance(const ConformanceRecord& record) {}
+};
+
+/**
+ * @brief Walk all Objective-C metadata of a binary.
+ *
+ * Classes are reported first, followed by categories and protocols - each
+ * in the order of their section.
+ *
+ * @param _Binary Reference to the target binary.
+ * @param _Stream Shared pointer to the target binary stream.
+ * @param visitor The visitor receiving all records.
+ */
+void visit(const ABIBase::TargetBinary& _Binary,
+           std::shared_ptr<ABIBase::TargetBinaryStream> _Stream, Visitor& visitor);
+
+/**
+ * @brief Walk all Objective-C metadata of a file.
+ *
+ * The same slice as in parseObjC will be selected.
+ *
+ * @param fileName The name of the file to walk.
+ * @param visitor The visitor receiving all records.
+ * @return bool False if the file could not be parsed or has no supported slice.
+ */
+bool visitObjC(const std::string& fileName, Visitor& visitor);
+
+} // namespace objc
+} // namespace umbrella
+
+#endif  // __UMBRELLA_OBJC_VISITOR_H__
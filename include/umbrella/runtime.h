@@ -17,6 +17,7 @@
 #if !defined(_UMBRELLA_RUNTIME_H__)
 #define _UMBRELLA_RUNTIME_H__
 
+#include <cstdint>
 #include <memory>
 
 #include "umbrella/visibility.h"
@@ -28,6 +29,16 @@ class BinaryStream;
 
 namespace umbrella {
 
+/**
+ * @brief CPU architectures of the supported Mach-O slices.
+ */
+enum class Architecture : uint32_t {
+  UNKNOWN = 0, /**< Unsupported CPU type. */
+  ARM64,       /**< arm64 (any subtype except arm64e). */
+  ARM64E,      /**< arm64e, i.e. with pointer authentication. */
+  X86_64,      /**< x86_64 (any subtype). */
+};
+
 /**
  * @brief Class representing an object in the process.
  */
@@ -83,7 +94,7 @@ public:
   using TargetBinaryStream = LIEF::BinaryStream;
 
 private:
-  const TargetBinary* Binary;                 /**< Pointer to the target binary. */
+  std::shared_ptr<const TargetBinary> Binary; /**< The target binary (possibly not owned). */
   uintptr_t ImageBase;                        /**< The image base address. */
   std::shared_ptr<LIEF::BinaryStream> Stream; /**< Shared pointer to the binary stream. */
 
@@ -91,7 +102,21 @@ public:
   /**
    * @brief Constructor for ABIBase class.
    *
-   * @param _Binary Pointer to the target binary.
+   * @param _Binary Shared pointer to the target binary, which will be kept
+   *                alive by this object (may be nullptr if the stream provides
+   *                the image layout itself, see hasBinary()).
+   * @param _Stream Shared pointer to the binary stream.
+   */
+  ABIBase(std::shared_ptr<const TargetBinary> _Binary,
+          std::shared_ptr<TargetBinaryStream> _Stream);
+
+  /**
+   * @brief Constructor for ABIBase class that does not own the binary.
+   *
+   * The caller has to keep the binary alive as long as this object.
+   *
+   * @param _Binary Pointer to the target binary (may be nullptr if the stream
+   *                provides the image layout itself, see hasBinary()).
    * @param _Stream Shared pointer to the binary stream.
    */
   ABIBase(const TargetBinary* _Binary, std::shared_ptr<TargetBinaryStream> _Stream);
@@ -112,12 +137,36 @@ public:
    */
   const TargetBinary& binary() const { return *Binary; }
 
+  /**
+   * @brief Check whether a target binary is available.
+   *
+   * ABIs created from a memory-mapped file (see ParseOptions::mapped) only
+   * provide the stream.
+   *
+   * @return bool True if binary() can be used.
+   */
+  bool hasBinary() const { return Binary != nullptr; }
+
   /**
    * @brief Get a reference to the binary stream.
    *
+   * If the calling thread has bound its own cursor to this ABI (see
+   * ScopedCursor), that cursor will be returned instead of the shared stream.
+   *
    * @return TargetBinaryStream& Reference to the binary stream.
    */
-  TargetBinaryStream& stream() { return *Stream; };
+  TargetBinaryStream& stream();
+
+  /**
+   * @brief Create an independent cursor over the binary stream.
+   *
+   * The returned stream reads the same (immutable) data, but has its own
+   * position and can therefore be used concurrently to the shared stream.
+   *
+   * @return std::shared_ptr<TargetBinaryStream> The new cursor, or nullptr if
+   *         the stream type does not support it.
+   */
+  std::shared_ptr<TargetBinaryStream> fork() const;
 
   /**
    * @brief Get the image base address.
@@ -125,6 +174,36 @@ public:
    * @return uintptr_t The image base address.
    */
   uintptr_t imagebase() const { return ImageBase; }
+
+  /**
+   * @brief Binds a private stream cursor to the calling thread.
+   *
+   * While an instance is alive, stream() returns the given cursor when
+   * called from the thread that created it.
+   */
+  class ScopedCursor {
+  private:
+    const ABIBase* PrevOwner;                   /**< Previously bound ABI. */
+    TargetBinaryStream* PrevStream;             /**< Previously bound cursor. */
+    std::shared_ptr<TargetBinaryStream> Cursor; /**< The bound cursor. */
+
+  public:
+    /**
+     * @brief Constructor for ScopedCursor class.
+     *
+     * @param _ABI The ABI the cursor will be bound to.
+     * @param _Cursor The cursor (e.g. created by ABIBase::fork).
+     */
+    ScopedCursor(const ABIBase& _ABI, std::shared_ptr<TargetBinaryStream> _Cursor);
+
+    /**
+     * @brief Destructor for ScopedCursor, restores the previous binding.
+     */
+    ~ScopedCursor();
+
+    ScopedCursor(const ScopedCursor&) = delete;
+    ScopedCursor& operator=(const ScopedCursor&) = delete;
+  };
 };
 
 } // namespace umbrella
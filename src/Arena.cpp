@@ -0,0 +1,60 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstdint>
+
+#include "umbrella/Arena.h"
+
+namespace umbrella {
+
+void* Arena::allocate(size_t size, size_t alignment) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto align = [alignment](std::byte* chunk, size_t offset) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(chunk) + offset;
+    return offset + (((address + alignment - 1) & ~(alignment - 1)) - address);
+  };
+
+  if (!chunks.empty()) {
+    const size_t offset = align(chunks.back().get(), used);
+    if (offset <= capacity && size <= capacity - offset) {
+      used = offset + size;
+      return chunks.back().get() + offset;
+    }
+  }
+
+  // The remainder of the current chunk is wasted, which is fine as long
+  // as objects are small compared to the chunk size.
+  const size_t chunkSize = std::max(CHUNK_SIZE, size + alignment);
+  chunks.emplace_back(new std::byte[chunkSize]);
+  capacity = chunkSize;
+  total += chunkSize;
+
+  const size_t offset = align(chunks.back().get(), 0);
+  used = offset + size;
+  return chunks.back().get() + offset;
+}
+
+size_t Arena::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return total;
+}
+
+size_t Arena::getChunkCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return chunks.size();
+}
+
+} // namespace umbrella
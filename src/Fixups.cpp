@@ -0,0 +1,484 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include "Fixups.h"
+
+namespace umbrella {
+
+namespace {
+
+// Only the parts of <mach-o/fixup-chains.h> that are needed to walk the
+// chains of 64-bit images.
+struct dyld_chained_fixups_header {
+    uint32_t fixups_version;
+    uint32_t starts_offset;
+    uint32_t imports_offset;
+    uint32_t symbols_offset;
+    uint32_t imports_count;
+    uint32_t imports_format;
+    uint32_t symbols_format;
+};
+
+struct dyld_chained_starts_in_segment {
+    uint32_t size;
+    uint16_t page_size;
+    uint16_t pointer_format;
+    uint64_t segment_offset;
+    uint32_t max_valid_pointer;
+    uint16_t page_count;
+    // followed by uint16_t page_start[page_count]
+};
+
+constexpr uint32_t DYLD_CHAINED_IMPORT = 1;
+constexpr uint32_t DYLD_CHAINED_IMPORT_ADDEND = 2;
+constexpr uint32_t DYLD_CHAINED_IMPORT_ADDEND64 = 3;
+
+constexpr uint16_t DYLD_CHAINED_PTR_START_NONE = 0xFFFF;
+constexpr uint16_t DYLD_CHAINED_PTR_START_MULTI = 0x8000;
+
+constexpr uint64_t SLOT_SIZE = sizeof(uint64_t);
+
+constexpr uint8_t BIND_OPCODE_MASK = 0xF0;
+constexpr uint8_t BIND_IMMEDIATE_MASK = 0x0F;
+constexpr uint8_t BIND_OPCODE_DONE = 0x00;
+constexpr uint8_t BIND_OPCODE_SET_DYLIB_ORDINAL_IMM = 0x10;
+constexpr uint8_t BIND_OPCODE_SET_DYLIB_ORDINAL_ULEB = 0x20;
+constexpr uint8_t BIND_OPCODE_SET_DYLIB_SPECIAL_IMM = 0x30;
+constexpr uint8_t BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM = 0x40;
+constexpr uint8_t BIND_OPCODE_SET_TYPE_IMM = 0x50;
+constexpr uint8_t BIND_OPCODE_SET_ADDEND_SLEB = 0x60;
+constexpr uint8_t BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB = 0x70;
+constexpr uint8_t BIND_OPCODE_ADD_ADDR_ULEB = 0x80;
+constexpr uint8_t BIND_OPCODE_DO_BIND = 0x90;
+constexpr uint8_t BIND_OPCODE_DO_BIND_ADD_ADDR_ULEB = 0xA0;
+constexpr uint8_t BIND_OPCODE_DO_BIND_ADD_ADDR_IMM_SCALED = 0xB0;
+constexpr uint8_t BIND_OPCODE_DO_BIND_ULEB_TIMES_SKIPPING_ULEB = 0xC0;
+
+/// Reads a value from the blob, false if it exceeds the blob.
+template <typename T>
+bool read(LIEF::span<const uint8_t> blob, uint64_t offset, T& value) {
+    if (offset > blob.size() || sizeof(T) > blob.size() - offset) {
+        return false;
+    }
+    std::memcpy(&value, blob.data() + offset, sizeof(T));
+    return true;
+}
+
+/// Reads an (S)LEB128 value, false if it exceeds the opcodes.
+bool leb128(LIEF::span<const uint8_t> data, size_t& offset, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; offset < data.size() && shift < 64; shift += 7) {
+        const uint8_t byte = data[offset++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t bits(uint64_t raw, unsigned shift, unsigned width) {
+    return (raw >> shift) & ((1ULL << width) - 1);
+}
+
+} // namespace
+
+bool ChainedFixups::decode(uint16_t format, uint64_t raw, bool& isBind, uint64_t& value,
+                           uint64_t& next) const {
+    switch (format) {
+    case PTR_ARM64E:
+    case PTR_ARM64E_USERLAND:
+    case PTR_ARM64E_USERLAND24: {
+        const bool auth = bits(raw, 63, 1);
+        isBind = bits(raw, 62, 1);
+        next = bits(raw, 51, 11) * 8;
+        if (isBind) {
+            // the addend of authenticated binds is always zero
+            value = bits(raw, 0, format == PTR_ARM64E_USERLAND24 ? 24 : 16);
+        } else if (auth) {
+            // authenticated rebases always store an offset
+            value = ImageBase + bits(raw, 0, 32);
+        } else {
+            value = bits(raw, 0, 43);
+            if (format != PTR_ARM64E) {
+                value += ImageBase;
+            }
+            value |= bits(raw, 43, 8) << 56;
+        }
+        return true;
+    }
+    case PTR_64:
+    case PTR_64_OFFSET:
+        isBind = bits(raw, 63, 1);
+        next = bits(raw, 51, 12) * 4;
+        if (isBind) {
+            value = bits(raw, 0, 24);
+        } else {
+            value = bits(raw, 0, 36);
+            if (format == PTR_64_OFFSET) {
+                value += ImageBase;
+            }
+            // top byte of tagged pointers
+            value |= bits(raw, 36, 8) << 56;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+void ChainedFixups::record(uint64_t location, bool isBind, uint64_t value) {
+    if (location < Begin || (location - Begin) % SLOT_SIZE != 0) {
+        return;
+    }
+
+    const uint64_t index = (location - Begin) / SLOT_SIZE;
+    if (index >= Slots.size()) {
+        return;
+    }
+
+    if (isBind) {
+        if (value < Imports.size()) {
+            Slots[index] = BIND_FLAG | static_cast<uint32_t>(value);
+        }
+    } else if (value >= ImageBase && value - ImageBase < BIND_FLAG - 1) {
+        // targets beyond 2GB are still resolved by rebase(), just not cached
+        Slots[index] = static_cast<uint32_t>(value - ImageBase + 1);
+    }
+}
+
+std::unique_ptr<ChainedFixups> ChainedFixups::parse(ImageStream& image) {
+    LIEF::span<const uint8_t> blob = image.chainedFixups();
+    dyld_chained_fixups_header header;
+    if (!read(blob, 0, header) || header.fixups_version != 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ChainedFixups> fixups(new ChainedFixups());
+    fixups->ImageBase = image.imagebase();
+
+    // The import count is untrusted, the whole table has to be part of the
+    // blob before anything is allocated for it.
+    uint64_t entrySize = 0;
+    switch (header.imports_format) {
+    case DYLD_CHAINED_IMPORT:
+        entrySize = 4;
+        break;
+    case DYLD_CHAINED_IMPORT_ADDEND:
+        entrySize = 8;
+        break;
+    case DYLD_CHAINED_IMPORT_ADDEND64:
+        entrySize = 16;
+        break;
+    default:
+        return nullptr;
+    }
+    if (header.imports_offset > blob.size() ||
+        header.imports_count > (blob.size() - header.imports_offset) / entrySize) {
+        return nullptr;
+    }
+
+    // Imports: names are only available uncompressed (symbols_format 0)
+    fixups->Imports.reserve(header.imports_count);
+    for (uint32_t i = 0; i < header.imports_count; i++) {
+        Import entry{{}, 0, 0, false};
+        uint64_t nameOffset = 0;
+        switch (header.imports_format) {
+        case DYLD_CHAINED_IMPORT: {
+            uint32_t raw;
+            if (!read(blob, header.imports_offset + i * 4ULL, raw)) {
+                return nullptr;
+            }
+            entry.libOrdinal = static_cast<int8_t>(bits(raw, 0, 8));
+            entry.weak = bits(raw, 8, 1);
+            nameOffset = bits(raw, 9, 23);
+            break;
+        }
+        case DYLD_CHAINED_IMPORT_ADDEND: {
+            uint32_t raw;
+            int32_t addend;
+            if (!read(blob, header.imports_offset + i * 8ULL, raw) ||
+                !read(blob, header.imports_offset + i * 8ULL + 4, addend)) {
+                return nullptr;
+            }
+            entry.libOrdinal = static_cast<int8_t>(bits(raw, 0, 8));
+            entry.weak = bits(raw, 8, 1);
+            entry.addend = addend;
+            nameOffset = bits(raw, 9, 23);
+            break;
+        }
+        case DYLD_CHAINED_IMPORT_ADDEND64: {
+            uint64_t raw;
+            uint64_t addend;
+            if (!read(blob, header.imports_offset + i * 16ULL, raw) ||
+                !read(blob, header.imports_offset + i * 16ULL + 8, addend)) {
+                return nullptr;
+            }
+            entry.libOrdinal = static_cast<int16_t>(bits(raw, 0, 16));
+            entry.weak = bits(raw, 16, 1);
+            entry.addend = static_cast<int64_t>(addend);
+            nameOffset = bits(raw, 32, 32);
+            break;
+        }
+        default:
+            return nullptr;
+        }
+
+        const uint64_t nameStart = static_cast<uint64_t>(header.symbols_offset) + nameOffset;
+        if (header.symbols_format == 0 && nameStart < blob.size()) {
+            const char* name = reinterpret_cast<const char*>(blob.data() + nameStart);
+            entry.name = std::string_view(name, strnlen(name, blob.size() - nameStart));
+        }
+        fixups->Imports.push_back(entry);
+    }
+
+    // Collect the segments that have fixups
+    uint32_t segmentCount = 0;
+    if (!read(blob, header.starts_offset, segmentCount)) {
+        return nullptr;
+    }
+
+    std::vector<uint64_t> starts;
+    uint64_t begin = std::numeric_limits<uint64_t>::max();
+    uint64_t end = 0;
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        uint32_t infoOffset = 0;
+        if (!read(blob, header.starts_offset + 4ULL + i * 4ULL, infoOffset)) {
+            return nullptr;
+        }
+        if (infoOffset == 0) {
+            // no fixups in this segment
+            continue;
+        }
+
+        const uint64_t offset = static_cast<uint64_t>(header.starts_offset) + infoOffset;
+        dyld_chained_starts_in_segment segment;
+        if (!read(blob, offset, segment) || segment.page_size == 0) {
+            continue;
+        }
+
+        // The page count is untrusted: the pages have to lie within the image
+        // and only the readable part of the segment can hold fixups, which
+        // bounds the slot table by the size of the mapped data.
+        const uint64_t start = fixups->ImageBase + segment.segment_offset;
+        const ImageStream::Segment* mapped = image.segment(start);
+        const uint64_t pages = static_cast<uint64_t>(segment.page_count) * segment.page_size;
+        if (!mapped || pages > image.size() - start) {
+            continue;
+        }
+        begin = std::min(begin, start);
+        end = std::max(end, std::min(start + pages, mapped->end));
+        starts.push_back(offset);
+        if (fixups->PointerFormat == 0) {
+            // all segments of an image use the same format in practice
+            fixups->PointerFormat = segment.pointer_format;
+        }
+    }
+
+    if (starts.empty()) {
+        return nullptr;
+    }
+    fixups->Begin = begin;
+    fixups->Slots.resize((end - begin + SLOT_SIZE - 1) / SLOT_SIZE);
+
+    // Walk every chain once
+    for (uint64_t offset : starts) {
+        dyld_chained_starts_in_segment segment;
+        read(blob, offset, segment);
+
+        const uint64_t pageStarts = offset + offsetof(dyld_chained_starts_in_segment, page_count) +
+                                    sizeof(uint16_t);
+        const uint64_t segmentStart = fixups->ImageBase + segment.segment_offset;
+        for (uint16_t page = 0; page < segment.page_count; page++) {
+            uint16_t start = 0;
+            if (!read(blob, pageStarts + page * 2ULL, start)) {
+                break;
+            }
+            if (start == DYLD_CHAINED_PTR_START_NONE || (start & DYLD_CHAINED_PTR_START_MULTI)) {
+                // multiple starts per page are only used by 32-bit formats
+                continue;
+            }
+
+            const uint64_t pageStart = segmentStart + static_cast<uint64_t>(page) * segment.page_size;
+            uint64_t location = pageStart + start;
+            // chains never leave their page, which also bounds malformed ones
+            while (location < pageStart + segment.page_size) {
+                auto raw = image.peek<uint64_t>(location);
+                bool isBind = false;
+                uint64_t value = 0;
+                uint64_t next = 0;
+                if (!raw || !fixups->decode(segment.pointer_format, *raw, isBind, value, next)) {
+                    break;
+                }
+
+                fixups->record(location, isBind, value);
+                if (next == 0) {
+                    break;
+                }
+                location += next;
+            }
+        }
+    }
+    return fixups;
+}
+
+uint64_t ChainedFixups::rebase(uint64_t raw) const {
+    bool isBind = false;
+    uint64_t value = 0;
+    uint64_t next = 0;
+    if (!decode(PointerFormat, raw, isBind, value, next) || isBind) {
+        return 0;
+    }
+    return value;
+}
+
+const ChainedFixups::Import* ChainedFixups::bind(uint64_t raw) const {
+    bool isBind = false;
+    uint64_t value = 0;
+    uint64_t next = 0;
+    if (!decode(PointerFormat, raw, isBind, value, next) || !isBind || value >= Imports.size()) {
+        return nullptr;
+    }
+    return &Imports[value];
+}
+
+const ChainedFixups::Import* ChainedFixups::bindAt(uint64_t location) const {
+    if (location < Begin || (location - Begin) / SLOT_SIZE >= Slots.size()) {
+        return nullptr;
+    }
+
+    const uint32_t slot = Slots[(location - Begin) / SLOT_SIZE];
+    if ((slot & BIND_FLAG) == 0) {
+        return nullptr;
+    }
+    return &Imports[slot & ~BIND_FLAG];
+}
+
+uint64_t ChainedFixups::targetAt(uint64_t location) const {
+    if (location < Begin || (location - Begin) / SLOT_SIZE >= Slots.size()) {
+        return 0;
+    }
+
+    const uint32_t slot = Slots[(location - Begin) / SLOT_SIZE];
+    if (slot == 0 || (slot & BIND_FLAG) != 0) {
+        return 0;
+    }
+    return ImageBase + slot - 1;
+}
+
+std::unique_ptr<ImportIndex> ImportIndex::parse(const ImageStream& image) {
+    LIEF::span<const uint8_t> opcodes = image.bindOpcodes();
+    const std::vector<uint64_t>& segments = image.segmentAddresses();
+    if (opcodes.empty()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ImportIndex> index(new ImportIndex());
+    std::string_view symbol;
+    uint64_t address = 0;
+    bool hasSegment = false;
+
+    // only the state needed to locate bind sites is tracked
+    auto bind = [&](uint64_t skip) {
+        if (hasSegment && !symbol.empty()) {
+            if (index->Names.empty() || index->Names.back() != symbol) {
+                index->Names.push_back(symbol);
+            }
+            index->Sites[address] = static_cast<uint32_t>(index->Names.size() - 1);
+        }
+        address += sizeof(uint64_t) + skip;
+    };
+
+    size_t offset = 0;
+    uint64_t value = 0;
+    uint64_t count = 0;
+    while (offset < opcodes.size()) {
+        const uint8_t opcode = opcodes[offset] & BIND_OPCODE_MASK;
+        const uint8_t immediate = opcodes[offset] & BIND_IMMEDIATE_MASK;
+        offset++;
+
+        bool valid = true;
+        switch (opcode) {
+        case BIND_OPCODE_DONE:
+            return index;
+        case BIND_OPCODE_SET_DYLIB_ORDINAL_IMM:
+        case BIND_OPCODE_SET_DYLIB_SPECIAL_IMM:
+        case BIND_OPCODE_SET_TYPE_IMM:
+            break;
+        case BIND_OPCODE_SET_DYLIB_ORDINAL_ULEB:
+        case BIND_OPCODE_SET_ADDEND_SLEB:
+            valid = leb128(opcodes, offset, value);
+            break;
+        case BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM: {
+            const char* name = reinterpret_cast<const char*>(opcodes.data() + offset);
+            symbol = std::string_view(name, strnlen(name, opcodes.size() - offset));
+            offset += symbol.size() + 1;
+            break;
+        }
+        case BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB:
+            valid = leb128(opcodes, offset, value) && immediate < segments.size();
+            if (valid) {
+                address = segments[immediate] + value;
+                hasSegment = true;
+            }
+            break;
+        case BIND_OPCODE_ADD_ADDR_ULEB:
+            valid = leb128(opcodes, offset, value);
+            address += value;
+            break;
+        case BIND_OPCODE_DO_BIND:
+            bind(0);
+            break;
+        case BIND_OPCODE_DO_BIND_ADD_ADDR_ULEB:
+            valid = leb128(opcodes, offset, value);
+            bind(value);
+            break;
+        case BIND_OPCODE_DO_BIND_ADD_ADDR_IMM_SCALED:
+            bind(immediate * sizeof(uint64_t));
+            break;
+        case BIND_OPCODE_DO_BIND_ULEB_TIMES_SKIPPING_ULEB:
+            valid = leb128(opcodes, offset, count) && leb128(opcodes, offset, value) &&
+                    count <= opcodes.size() * 8;
+            for (uint64_t i = 0; valid && i < count; i++) {
+                bind(value);
+            }
+            break;
+        default:
+            // e.g. BIND_OPCODE_THREADED, which is superseded by chained fixups
+            valid = false;
+            break;
+        }
+
+        if (!valid) {
+            break;
+        }
+    }
+    return index;
+}
+
+std::string_view ImportIndex::at(uint64_t location) const {
+    auto result = Sites.find(location);
+    if (result == Sites.end()) {
+        return {};
+    }
+    return Names[result->second];
+}
+
+} // namespace umbrella
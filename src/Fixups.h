@@ -0,0 +1,115 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_PRIVATE_FIXUPS_H__)
+#define __UMBRELLA_PRIVATE_FIXUPS_H__
+
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ImageStream.h"
+
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+
+// Decoded LC_DYLD_CHAINED_FIXUPS of an image.
+//
+// All chains are walked once. The result is a dense table with one entry
+// per pointer-sized slot of the fixed-up segments, plus the import table
+// that binds refer to. Raw pointer values can also be decoded on their own,
+// as the pointer format is known.
+class ChainedFixups {
+  public:
+    // an imported symbol referenced by binds
+    struct Import {
+        std::string_view name;
+        int64_t addend;
+        int32_t libOrdinal;
+        bool weak;
+    };
+
+    // pointer formats (DYLD_CHAINED_PTR_*) that can be decoded
+    enum Format : uint16_t {
+        PTR_ARM64E = 1,
+        PTR_64 = 2,
+        PTR_64_OFFSET = 6,
+        PTR_ARM64E_USERLAND = 9,
+        PTR_ARM64E_USERLAND24 = 12,
+    };
+
+  private:
+    uint64_t ImageBase = 0;
+    uint16_t PointerFormat = 0;
+    std::vector<Import> Imports;
+
+    // slot table covering [Begin, Begin + Slots.size() * 8): 0 if there is
+    // no fixup, BIND_FLAG | import index for binds and offset + 1 (relative
+    // to the image base) for rebases
+    static constexpr uint32_t BIND_FLAG = 0x80000000;
+    uint64_t Begin = 0;
+    std::vector<uint32_t> Slots;
+
+    // decodes a chain entry, returns false for unsupported formats
+    bool decode(uint16_t format, uint64_t raw, bool& isBind, uint64_t& value,
+                uint64_t& next) const;
+    void record(uint64_t location, bool isBind, uint64_t value);
+
+  public:
+    // returns nullptr if the image has no (supported) chained fixups
+    static std::unique_ptr<ChainedFixups> parse(ImageStream& image);
+
+    inline uint16_t format() const { return PointerFormat; }
+    inline size_t importCount() const { return Imports.size(); }
+
+    // decodes a raw pointer value, 0 for binds
+    uint64_t rebase(uint64_t raw) const;
+
+    // decodes a raw pointer value, nullptr for rebases
+    const Import* bind(uint64_t raw) const;
+
+    // looks up the fixup stored at a location in O(1), nullptr if it is
+    // not a bind
+    const Import* bindAt(uint64_t location) const;
+
+    // looks up the target of a rebase stored at a location in O(1), 0 if
+    // there is no rebase
+    uint64_t targetAt(uint64_t location) const;
+};
+
+// Imported symbols bound by the bind opcodes of LC_DYLD_INFO(_ONLY), which
+// is used by images without chained fixups. Only the bind sites are
+// indexed, other information of the opcodes is skipped.
+class ImportIndex {
+  private:
+    // the names are views into the opcodes
+    std::vector<std::string_view> Names;
+    std::unordered_map<uint64_t, uint32_t> Sites;
+
+  public:
+    // returns nullptr if the image has no bind opcodes
+    static std::unique_ptr<ImportIndex> parse(const ImageStream& image);
+
+    inline size_t size() const { return Sites.size(); }
+
+    // the symbol bound at the given location, empty if there is none
+    std::string_view at(uint64_t location) const;
+};
+
+} // namespace umbrella
+
+#endif  // __UMBRELLA_PRIVATE_FIXUPS_H__
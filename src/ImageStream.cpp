@@ -0,0 +1,136 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+
+#include "ImageStream.h"
+
+namespace umbrella {
+
+namespace {
+
+constexpr int32_t CPU_TYPE_X86_64 = 0x01000007;
+constexpr int32_t CPU_TYPE_ARM64 = 0x0100000C;
+constexpr uint32_t CPU_SUBTYPE_MASK = 0xff000000;
+constexpr uint32_t CPU_SUBTYPE_ARM64E = 2;
+
+} // namespace
+
+Architecture ImageStream::architecture(int32_t cpuType, uint32_t cpuSubtype) {
+    switch (cpuType) {
+    case CPU_TYPE_ARM64:
+        // the upper bits store capabilities, e.g. the pointer authentication ABI
+        if ((cpuSubtype & ~CPU_SUBTYPE_MASK) == CPU_SUBTYPE_ARM64E) {
+            return Architecture::ARM64E;
+        }
+        return Architecture::ARM64;
+    case CPU_TYPE_X86_64:
+        return Architecture::X86_64;
+    default:
+        return Architecture::UNKNOWN;
+    }
+}
+
+void ImageStream::setSegments(SegmentTable _Table) {
+    std::sort(_Table.begin(), _Table.end(),
+              [](const Segment& a, const Segment& b) { return a.start < b.start; });
+
+    End = 0;
+    for (const Segment& segment : _Table) {
+        End = std::max(End, segment.end);
+    }
+    if (MemoryBase > ImageBase && End > ImageBase) {
+        // addresses may also be relative to the memory base (see translate)
+        End += MemoryBase - ImageBase;
+    }
+    Segments = std::make_shared<const SegmentTable>(std::move(_Table));
+    LastHit = 0;
+}
+
+uint64_t ImageStream::size() const {
+    return End;
+}
+
+const ImageStream::Segment* ImageStream::find(uint64_t address) const {
+    const SegmentTable& table = *Segments;
+    if (LastHit < table.size()) {
+        // consecutive reads almost always hit the same segment
+        const Segment& last = table[LastHit];
+        if (address >= last.start && address < last.end) {
+            return &last;
+        }
+    }
+
+    auto it = std::upper_bound(table.begin(), table.end(), address,
+                               [](uint64_t value, const Segment& s) { return value < s.start; });
+    if (it == table.begin()) {
+        return nullptr;
+    }
+
+    --it;
+    if (address >= it->end) {
+        return nullptr;
+    }
+    LastHit = static_cast<size_t>(it - table.begin());
+    return &*it;
+}
+
+uint64_t ImageStream::address(const uint8_t* data) const {
+    for (const Segment& segment : *Segments) {
+        // one past the end is allowed, that is where a section may end
+        if (data >= segment.data && data <= segment.data + (segment.end - segment.start)) {
+            return segment.start + static_cast<uint64_t>(data - segment.data);
+        }
+    }
+    return 0;
+}
+
+uint64_t ImageStream::translate(uint64_t offset) const {
+    uint64_t address = offset;
+    if (MemoryBase > 0 && offset > MemoryBase) {
+        address -= MemoryBase;
+        address += ImageBase;
+    }
+    return address;
+}
+
+LIEF::result<const void*> ImageStream::read_at(uint64_t offset, uint64_t size) const {
+    const uint64_t address = translate(offset);
+    const Segment* segment = find(address);
+    if (segment == nullptr || size > segment->end - address) {
+        // unmapped or the read would cross the end of the segment's content
+        return make_error_code(lief_errors::read_error);
+    }
+    return segment->data + (address - segment->start);
+}
+
+LIEF::result<std::string_view> ImageStream::peek_string_view(uint64_t offset) const {
+    const uint64_t address = translate(offset);
+    const Segment* segment = find(address);
+    if (segment == nullptr) {
+        return make_error_code(lief_errors::read_error);
+    }
+
+    const char* begin = reinterpret_cast<const char*>(segment->data + (address - segment->start));
+    const void* end = std::memchr(begin, '\0', segment->end - address);
+    if (end == nullptr) {
+        // not terminated within the segment
+        return make_error_code(lief_errors::read_error);
+    }
+    return std::string_view(begin, static_cast<const char*>(end) - begin);
+}
+
+} // namespace umbrella
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_PRIVATE_IMAGE_STREAM_H__)
+#define __UMBRELLA_PRIVATE_IMAGE_STREAM_H__
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <LIEF/BinaryStream/BinaryStream.hpp>
+
+#include "umbrella/runtime.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+
+// A stream over the virtual address space of a loaded image. Reads are
+// served from a sorted table of segment contents.
+class ImageStream : public LIEF::BinaryStream {
+  public:
+    // readable part of a segment, i.e. [start, end) maps to data
+    struct Segment {
+        uint64_t start;
+        uint64_t end;
+        const uint8_t* data;
+    };
+
+    // immutable and sorted by start address, shared by all clones
+    using SegmentTable = std::vector<Segment>;
+
+  protected:
+    std::shared_ptr<const SegmentTable> Segments;
+    uint64_t ImageBase = 0;
+    uint64_t MemoryBase = 0;
+    uint64_t End = 0;
+    Architecture Arch = Architecture::UNKNOWN;
+
+    // payload of LC_DYLD_CHAINED_FIXUPS, empty if there is none
+    LIEF::span<const uint8_t> ChainedFixupData;
+
+    // bind opcodes of LC_DYLD_INFO(_ONLY), empty if there are none
+    LIEF::span<const uint8_t> BindOpcodeData;
+
+    // start address of each segment in load command order, which is how
+    // bind opcodes refer to segments
+    std::vector<uint64_t> SegmentAddresses;
+
+    // index of the segment that served the last read (per cursor)
+    mutable size_t LastHit = 0;
+
+    ImageStream() = default;
+
+    // clones share the segment table, but not the position
+    ImageStream(const ImageStream& _Other)
+        : LIEF::BinaryStream(), Segments{_Other.Segments}, ImageBase{_Other.ImageBase},
+          MemoryBase{_Other.MemoryBase}, End{_Other.End}, Arch{_Other.Arch},
+          ChainedFixupData{_Other.ChainedFixupData}, BindOpcodeData{_Other.BindOpcodeData},
+          SegmentAddresses{_Other.SegmentAddresses} {};
+
+    // sorts the table and computes the end of the address space
+    void setSegments(SegmentTable _Table);
+
+    const Segment* find(uint64_t address) const;
+    uint64_t translate(uint64_t offset) const;
+
+  public:
+    // one past the highest readable address
+    uint64_t size() const override;
+
+    LIEF::result<const void*> read_at(uint64_t offset, uint64_t size) const override;
+
+    // returns a view of the NULL-terminated string at the given offset
+    // without copying it, the view is valid as long as the image
+    LIEF::result<std::string_view> peek_string_view(uint64_t offset) const;
+
+    // the address of a byte in the contents of a segment (e.g. a section
+    // returned by section()), 0 if it is not part of the image
+    uint64_t address(const uint8_t* data) const;
+
+    // the readable segment containing an address, nullptr if it is unmapped
+    inline const Segment* segment(uint64_t address) const { return find(address); }
+
+    inline uint64_t imagebase() const { return ImageBase; }
+
+    inline Architecture architecture() const { return Arch; }
+
+    // the raw dyld_chained_fixups_header and everything it refers to
+    inline LIEF::span<const uint8_t> chainedFixups() const { return ChainedFixupData; }
+
+    // the raw (non-lazy) bind opcodes
+    inline LIEF::span<const uint8_t> bindOpcodes() const { return BindOpcodeData; }
+
+    inline const std::vector<uint64_t>& segmentAddresses() const { return SegmentAddresses; }
+
+    // maps a Mach-O CPU type and subtype to one of the supported architectures
+    static Architecture architecture(int32_t cpuType, uint32_t cpuSubtype);
+
+    // returns the contents of the first section with the given name
+    virtual LIEF::span<const uint8_t> section(const std::string& name) const = 0;
+
+    // creates a new stream with its own position over the same image
+    virtual std::shared_ptr<ImageStream> clone() const = 0;
+};
+
+} // namespace umbrella
+
+#endif  // __UMBRELLA_PRIVATE_IMAGE_STREAM_H__
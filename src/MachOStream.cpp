@@ -22,26 +22,62 @@ using namespace LIEF::MachO;
 
 namespace umbrella {
 
-uint64_t MachOStream::size() const {
-    // What size do we need here?
-    return static_cast<uint64_t>(-1);
+MachOStream::MachOStream(std::shared_ptr<const LIEF::MachO::Binary> _Binary)
+    : Binary{std::move(_Binary)} {
+    ImageBase = Binary->imagebase();
+    MemoryBase = Binary->memory_base_address();
+    Arch = architecture(static_cast<int32_t>(Binary->header().cpu_type()),
+                        Binary->header().cpu_subtype());
+
+    SegmentTable table;
+    for (const SegmentCommand& cmd : Binary->segments()) {
+        SegmentAddresses.push_back(cmd.virtual_address());
+        LIEF::span<const uint8_t> content = cmd.content();
+        if (content.empty()) {
+            // e.g. __PAGEZERO, nothing to read from
+            continue;
+        }
+        const uint64_t start = cmd.virtual_address();
+        table.push_back({start, start + content.size(), content.data()});
+    }
+    setSegments(std::move(table));
+
+    if (const DyldChainedFixups* fixups = Binary->dyld_chained_fixups()) {
+        ChainedFixupData = linkedit(fixups->data_offset(), fixups->data_size());
+    }
+    if (const DyldInfo* info = Binary->dyld_info()) {
+        BindOpcodeData = linkedit(info->bind().first, info->bind().second);
+    }
 }
 
-LIEF::result<const void*> MachOStream::read_at(uint64_t offset, uint64_t size) const {
-    uint64_t address = offset;
-    if (Binary->memory_base_address() > 0 && offset > Binary->memory_base_address()) {
-        address -= Binary->memory_base_address();
-        address += Binary->imagebase();
+LIEF::span<const uint8_t> MachOStream::linkedit(uint64_t fileOffset, uint64_t size) const {
+    // load commands only store file offsets, which are resolved against the
+    // content of __LINKEDIT
+    const SegmentCommand* segment = Binary->get_segment("__LINKEDIT");
+    if (!segment || fileOffset < segment->file_offset()) {
+        return {};
     }
 
-    const SegmentCommand* cmd = Binary->segment_from_virtual_address(address);
-    if (cmd == nullptr) {
-        return make_error_code(lief_errors::read_error);
+    LIEF::span<const uint8_t> content = segment->content();
+    const uint64_t offset = fileOffset - segment->file_offset();
+    if (offset > content.size() || size > content.size() - offset) {
+        return {};
     }
+    return {content.data() + offset, static_cast<size_t>(size)};
+}
 
-    LIEF::span<const uint8_t> content = cmd->content();
-    uintptr_t rel_offset = address - cmd->virtual_address();
-    return content.data() + rel_offset;
+MachOStream::MachOStream(const LIEF::MachO::Binary& _Binary)
+    // aliasing constructor: refers to the binary without owning it
+    : MachOStream(std::shared_ptr<const LIEF::MachO::Binary>(
+          std::shared_ptr<const LIEF::MachO::Binary>(), &_Binary)) {}
+
+LIEF::span<const uint8_t> MachOStream::section(const std::string& name) const {
+    for (const auto& section : Binary->sections()) {
+        if (section.name() == name) {
+            return section.content();
+        }
+    }
+    return {};
 }
 
 } // namespace umbrella
@@ -17,7 +17,10 @@
 #if !defined(__UMBRELLA_PRIVATE_MACHO_STREAM_H__)
 #define __UMBRELLA_PRIVATE_MACHO_STREAM_H__
 
-#include <LIEF/BinaryStream/BinaryStream.hpp>
+#include <memory>
+#include <string>
+
+#include "ImageStream.h"
 
 #include "umbrella/visibility.h"
 
@@ -31,18 +34,34 @@ class Binary;
 
 namespace umbrella {
 
-class MachOStream : public LIEF::BinaryStream {
+// An image stream over a Mach-O binary parsed by LIEF.
+class MachOStream : public ImageStream {
   private:
-    const LIEF::MachO::Binary* Binary = nullptr;
+    // possibly not owned, see the constructors
+    std::shared_ptr<const LIEF::MachO::Binary> Binary;
+
+    // maps a file range to the content of __LINKEDIT, empty if it is not
+    // fully contained in it
+    LIEF::span<const uint8_t> linkedit(uint64_t fileOffset, uint64_t size) const;
 
   public:
-    MachOStream(const LIEF::MachO::Binary& _Binary) : Binary{&_Binary} {};
-    // must be overriden
-    uint64_t size() const override;
+    // shares ownership of the binary with all clones
+    MachOStream(std::shared_ptr<const LIEF::MachO::Binary> _Binary);
 
-    LIEF::result<const void*> read_at(uint64_t offset, uint64_t size) const override;
+    // the binary must outlive this stream and all of its clones
+    MachOStream(const LIEF::MachO::Binary& _Binary);
 
     inline const LIEF::MachO::Binary& binary() const { return *Binary; }
+
+    // the binary as shared with all clones (does not own it if the stream
+    // was created from a reference)
+    inline std::shared_ptr<const LIEF::MachO::Binary> sharedBinary() const { return Binary; }
+
+    LIEF::span<const uint8_t> section(const std::string& name) const override;
+
+    inline std::shared_ptr<ImageStream> clone() const override {
+        return std::make_shared<MachOStream>(*this);
+    }
 };
 
 } // namespace umbrella
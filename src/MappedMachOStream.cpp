@@ -0,0 +1,360 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedMachOStream.h"
+
+namespace umbrella {
+
+namespace {
+
+// Only the parts of <mach-o/loader.h> and <mach-o/fat.h> that are needed
+// to locate segments and sections.
+constexpr uint32_t FAT_MAGIC = 0xcafebabe;
+constexpr uint32_t FAT_MAGIC_64 = 0xcafebabf;
+constexpr uint32_t MH_MAGIC_64 = 0xfeedfacf;
+constexpr uint32_t LC_SEGMENT_64 = 0x19;
+constexpr uint32_t LC_DYLD_CHAINED_FIXUPS = 0x80000034;
+constexpr uint32_t LC_DYLD_INFO = 0x22;
+constexpr uint32_t LC_DYLD_INFO_ONLY = 0x80000022;
+
+constexpr uint32_t SECTION_TYPE = 0x000000ff;
+constexpr uint32_t S_ZEROFILL = 0x1;
+constexpr uint32_t S_GB_ZEROFILL = 0xc;
+constexpr uint32_t S_THREAD_LOCAL_ZEROFILL = 0x12;
+
+struct fat_header {
+    uint32_t magic;
+    uint32_t nfat_arch;
+};
+
+struct fat_arch {
+    int32_t cputype;
+    int32_t cpusubtype;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t align;
+};
+
+struct fat_arch_64 {
+    int32_t cputype;
+    int32_t cpusubtype;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t align;
+    uint32_t reserved;
+};
+
+struct mach_header_64 {
+    uint32_t magic;
+    int32_t cputype;
+    int32_t cpusubtype;
+    uint32_t filetype;
+    uint32_t ncmds;
+    uint32_t sizeofcmds;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct load_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+};
+
+struct segment_command_64 {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    char segname[16];
+    uint64_t vmaddr;
+    uint64_t vmsize;
+    uint64_t fileoff;
+    uint64_t filesize;
+    int32_t maxprot;
+    int32_t initprot;
+    uint32_t nsects;
+    uint32_t flags;
+};
+
+struct linkedit_data_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t dataoff;
+    uint32_t datasize;
+};
+
+struct dyld_info_command {
+    uint32_t cmd;
+    uint32_t cmdsize;
+    uint32_t rebase_off;
+    uint32_t rebase_size;
+    uint32_t bind_off;
+    uint32_t bind_size;
+    uint32_t weak_bind_off;
+    uint32_t weak_bind_size;
+    uint32_t lazy_bind_off;
+    uint32_t lazy_bind_size;
+    uint32_t export_off;
+    uint32_t export_size;
+};
+
+struct section_64 {
+    char sectname[16];
+    char segname[16];
+    uint64_t addr;
+    uint64_t size;
+    uint32_t offset;
+    uint32_t align;
+    uint32_t reloff;
+    uint32_t nreloc;
+    uint32_t flags;
+    uint32_t reserved1;
+    uint32_t reserved2;
+    uint32_t reserved3;
+};
+
+/// Reads a struct from the file, nullptr if it exceeds the file.
+template <typename T>
+const T* at(const MappedFile& file, uint64_t offset) {
+    if (offset > file.size() || sizeof(T) > file.size() - offset) {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(file.data() + offset);
+}
+
+/// Returns a range of the file, empty if it exceeds the file.
+LIEF::span<const uint8_t> range(const MappedFile& file, uint64_t offset, uint64_t size) {
+    if (offset > file.size() || size > file.size() - offset) {
+        return {};
+    }
+    return {file.data() + offset, static_cast<size_t>(size)};
+}
+
+/// Fat headers are always stored in big-endian byte order.
+template <typename T>
+T swap(T value) {
+    using U = std::make_unsigned_t<T>;
+    const U raw = static_cast<U>(value);
+    U result = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        result = static_cast<U>((result << 8) | ((raw >> (i * 8)) & 0xff));
+    }
+    return static_cast<T>(result);
+}
+
+/// Names in load commands are not NULL-terminated if they use all 16 bytes.
+std::string name(const char (&raw)[16]) {
+    return std::string(raw, strnlen(raw, sizeof(raw)));
+}
+
+} // namespace
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+    if (Data) {
+        munmap(const_cast<uint8_t*>(Data), Size);
+    }
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& fileName) {
+#if defined(_WIN32)
+    return nullptr;
+#else
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the descriptor
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return std::shared_ptr<MappedFile>(new MappedFile(static_cast<const uint8_t*>(data), size));
+#endif
+}
+
+std::vector<std::shared_ptr<MappedMachOStream>> MappedMachOStream::open(
+    const std::string& fileName) {
+    std::vector<std::shared_ptr<MappedMachOStream>> slices;
+    std::shared_ptr<MappedFile> file = MappedFile::open(fileName);
+    if (!file) {
+        return slices;
+    }
+
+    const fat_header* fat = at<fat_header>(*file, 0);
+    if (!fat) {
+        return slices;
+    }
+
+    const uint32_t magic = swap(fat->magic);
+    if (magic != FAT_MAGIC && magic != FAT_MAGIC_64) {
+        std::shared_ptr<MappedMachOStream> stream(new MappedMachOStream(file));
+        if (stream->load(0)) {
+            slices.push_back(std::move(stream));
+        }
+        return slices;
+    }
+
+    // All slices share the same mapping
+    const uint32_t count = swap(fat->nfat_arch);
+    const bool is64 = magic == FAT_MAGIC_64;
+    const size_t entrySize = is64 ? sizeof(fat_arch_64) : sizeof(fat_arch);
+    for (uint32_t i = 0; i < count; i++) {
+        const uint64_t offset = sizeof(fat_header) + i * entrySize;
+        uint64_t sliceOffset;
+        if (is64) {
+            const fat_arch_64* arch = at<fat_arch_64>(*file, offset);
+            if (!arch) {
+                break;
+            }
+            sliceOffset = swap(arch->offset);
+        } else {
+            const fat_arch* arch = at<fat_arch>(*file, offset);
+            if (!arch) {
+                break;
+            }
+            sliceOffset = swap(arch->offset);
+        }
+
+        std::shared_ptr<MappedMachOStream> stream(new MappedMachOStream(file));
+        if (stream->load(sliceOffset)) {
+            slices.push_back(std::move(stream));
+        }
+    }
+    return slices;
+}
+
+bool MappedMachOStream::load(size_t sliceOffset) {
+    const MappedFile& file = *File;
+    const mach_header_64* header = at<mach_header_64>(file, sliceOffset);
+    if (!header || header->magic != MH_MAGIC_64) {
+        return false;
+    }
+
+    Arch = architecture(header->cputype, static_cast<uint32_t>(header->cpusubtype));
+    if (Arch == Architecture::UNKNOWN) {
+        return false;
+    }
+
+    SegmentTable segments;
+    auto sections = std::make_shared<SectionTable>();
+    bool hasImageBase = false;
+
+    uint64_t offset = sliceOffset + sizeof(mach_header_64);
+    const uint64_t end = offset + header->sizeofcmds;
+    for (uint32_t i = 0; i < header->ncmds && offset < end; i++) {
+        const load_command* command = at<load_command>(file, offset);
+        if (!command || command->cmdsize < sizeof(load_command)) {
+            // truncated or malformed, keep what has been parsed so far
+            break;
+        }
+
+        const uint64_t next = offset + command->cmdsize;
+        if (command->cmd == LC_DYLD_CHAINED_FIXUPS) {
+            if (const linkedit_data_command* fixups = at<linkedit_data_command>(file, offset)) {
+                ChainedFixupData = range(file, sliceOffset + fixups->dataoff, fixups->datasize);
+            }
+        } else if (command->cmd == LC_DYLD_INFO || command->cmd == LC_DYLD_INFO_ONLY) {
+            if (const dyld_info_command* info = at<dyld_info_command>(file, offset)) {
+                BindOpcodeData = range(file, sliceOffset + info->bind_off, info->bind_size);
+            }
+        }
+        if (command->cmd != LC_SEGMENT_64) {
+            offset = next;
+            continue;
+        }
+
+        const segment_command_64* segment = at<segment_command_64>(file, offset);
+        if (!segment || command->cmdsize < sizeof(segment_command_64)) {
+            break;
+        }
+
+        SegmentAddresses.push_back(segment->vmaddr);
+        const std::string segmentName = name(segment->segname);
+        if (!hasImageBase && (segmentName == "__TEXT" ||
+                              (segment->fileoff == 0 && segment->filesize != 0))) {
+            ImageBase = segment->vmaddr;
+            hasImageBase = true;
+        }
+
+        const uint64_t fileOffset = sliceOffset + segment->fileoff;
+        uint64_t size = std::min(segment->filesize, segment->vmsize);
+        if (fileOffset < file.size() && size != 0) {
+            size = std::min<uint64_t>(size, file.size() - fileOffset);
+            segments.push_back({segment->vmaddr, segment->vmaddr + size, file.data() + fileOffset});
+        }
+
+        uint64_t sectionOffset = offset + sizeof(segment_command_64);
+        // sections must be contained in the load command, not just start in it
+        for (uint32_t j = 0; j < segment->nsects && sectionOffset + sizeof(section_64) <= next;
+             j++) {
+            const section_64* section = at<section_64>(file, sectionOffset);
+            if (!section) {
+                break;
+            }
+            sectionOffset += sizeof(section_64);
+
+            const uint32_t type = section->flags & SECTION_TYPE;
+            if (type == S_ZEROFILL || type == S_GB_ZEROFILL || type == S_THREAD_LOCAL_ZEROFILL) {
+                continue;
+            }
+
+            const uint64_t dataOffset = sliceOffset + section->offset;
+            if (dataOffset > file.size() || section->size > file.size() - dataOffset) {
+                continue;
+            }
+            // only the first section with a given name is used (same as LIEF)
+            sections->emplace(name(section->sectname),
+                              LIEF::span<const uint8_t>(file.data() + dataOffset, section->size));
+        }
+        offset = next;
+    }
+
+    if (segments.empty()) {
+        return false;
+    }
+    setSegments(std::move(segments));
+    Sections = std::move(sections);
+    return true;
+}
+
+LIEF::span<const uint8_t> MappedMachOStream::section(const std::string& name) const {
+    auto result = Sections->find(name);
+    if (result != Sections->end()) {
+        return result->second;
+    }
+    return {};
+}
+
+} // namespace umbrella
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(__UMBRELLA_PRIVATE_MAPPED_MACHO_STREAM_H__)
+#define __UMBRELLA_PRIVATE_MAPPED_MACHO_STREAM_H__
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ImageStream.h"
+
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+
+// A read-only memory mapping of a whole file.
+class MappedFile {
+  private:
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+
+    MappedFile(const uint8_t* _Data, size_t _Size) : Data{_Data}, Size{_Size} {};
+
+  public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // returns nullptr if the file can't be mapped
+    static std::shared_ptr<MappedFile> open(const std::string& fileName);
+
+    inline const uint8_t* data() const { return Data; }
+    inline size_t size() const { return Size; }
+};
+
+// An image stream over a memory-mapped 64-bit Mach-O file. In contrast to
+// MachOStream, only the header, segments and sections are parsed - which
+// is all ABIObjectiveC::parse needs.
+class MappedMachOStream : public ImageStream {
+  public:
+    using SectionTable = std::unordered_map<std::string, LIEF::span<const uint8_t>>;
+
+  private:
+    std::shared_ptr<MappedFile> File;
+    std::shared_ptr<const SectionTable> Sections;
+
+    MappedMachOStream(std::shared_ptr<MappedFile> _File) : File{std::move(_File)} {};
+
+    // parses the load commands of the slice at the given file offset
+    bool load(size_t sliceOffset);
+
+  public:
+    // maps the file and returns one stream per supported 64-bit slice (see
+    // ImageStream::architecture), all of them share the mapping
+    static std::vector<std::shared_ptr<MappedMachOStream>> open(const std::string& fileName);
+
+    LIEF::span<const uint8_t> section(const std::string& name) const override;
+
+    inline std::shared_ptr<ImageStream> clone() const override {
+        return std::shared_ptr<MappedMachOStream>(new MappedMachOStream(*this));
+    }
+};
+
+} // namespace umbrella
+
+#endif  // __UMBRELLA_PRIVATE_MAPPED_MACHO_STREAM_H__
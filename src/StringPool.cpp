@@ -0,0 +1,74 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "umbrella/StringPool.h"
+
+namespace umbrella {
+
+StringPool::Handle StringPool::insert(std::string_view value, bool copy) {
+  auto result = lookup.find(value);
+  if (result != lookup.end()) {
+    return result->second;
+  }
+
+  if (copy) {
+    value = storage.emplace_back(value);
+  }
+  const Handle handle = static_cast<Handle>(strings.size());
+  strings.push_back(value);
+  lookup.emplace(value, handle);
+  return handle;
+}
+
+StringPool::Handle StringPool::add(std::string_view value, bool copy) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return insert(value, copy);
+}
+
+std::string_view StringPool::intern(std::string_view value, bool copy) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return strings[insert(value, copy)];
+}
+
+bool StringPool::find(std::string_view value, Handle& handle) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto result = lookup.find(value);
+  if (result == lookup.end()) {
+    return false;
+  }
+  handle = result->second;
+  return true;
+}
+
+std::string_view StringPool::get(Handle handle) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (handle >= strings.size()) {
+    return {};
+  }
+  return strings[handle];
+}
+
+size_t StringPool::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return strings.size();
+}
+
+std::shared_ptr<StringPool> StringPool::global() {
+  // intentionally leaked, strings must outlive all static destructors
+  static std::shared_ptr<StringPool>* pool = new std::shared_ptr<StringPool>(new StringPool());
+  return *pool;
+}
+
+} // namespace umbrella
@@ -13,24 +13,91 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include <LIEF/Abstract.hpp>
 #include <LIEF/MachO.hpp>
 #include <LIEF/BinaryStream/BinaryStream.hpp>
 #include <LIEF/BinaryStream/SpanStream.hpp>
 
 #include "objc/Parsing.h"  // private include
+#include "Fixups.h"
+#include "ImageStream.h"
 #include "MachOStream.h"
+#include "MappedMachOStream.h"
 
+#include "umbrella/objc.h"
 #include "umbrella/objc/ABI.h"
 #include "umbrella/objc/Category.h"
 #include "umbrella/objc/Class.h"
 #include "umbrella/objc/Protocol.h"
+#include "umbrella/objc/Visitor.h"
 #include "umbrella/visibility.h"
 
 namespace umbrella {
 namespace objc {
 
+ABIObjectiveC::ABIObjectiveC(std::shared_ptr<const TargetBinary> _Binary,
+                             std::shared_ptr<TargetBinaryStream> _Stream,
+                             const ParseOptions& _Options)
+    : ABIBase(std::move(_Binary), _Stream), options(_Options) {
+  // All cursors created by fork() share the type of the initial stream
+  zeroCopy = _Options.zeroCopy && !_Options.sharedStrings &&
+             dynamic_cast<ImageStream*>(_Stream.get()) != nullptr;
+  stringPool = _Options.sharedStrings ? StringPool::global() : std::make_shared<StringPool>();
+  if (auto image = dynamic_cast<ImageStream*>(_Stream.get())) {
+    fixups = ChainedFixups::parse(*image);
+    if (!fixups) {
+      imports = ImportIndex::parse(*image);
+    }
+  }
+}
+
+ABIObjectiveC::ABIObjectiveC(const TargetBinary* _Binary,
+                             std::shared_ptr<TargetBinaryStream> _Stream,
+                             const ParseOptions& _Options)
+    // aliasing constructor: refers to the binary without owning it
+    : ABIObjectiveC(std::shared_ptr<const TargetBinary>(std::shared_ptr<const TargetBinary>(),
+                                                        _Binary),
+                    std::move(_Stream), _Options) {}
+
+ABIObjectiveC::~ABIObjectiveC() {
+  // Cached objects may reference each other in cycles (e.g. the metaclass
+  // of a root class), which would otherwise keep them alive forever.
+  for (auto& entry : classCache) {
+    if (entry.second) {
+      entry.second->superClass.reset();
+      entry.second->metaClass.reset();
+    }
+  }
+  for (auto& entry : protocolCache) {
+    if (entry.second) {
+      entry.second->protocols.clear();
+    }
+  }
+  for (auto& protocol : forgottenProtocols) {
+    protocol->protocols.clear();
+  }
+}
+
+void ABIObjectiveC::forget(const std::shared_ptr<Protocol>& protocol) {
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto res = protocolCache.find(protocol->getAddress());
+  if (res != std::end(protocolCache) && res->second == protocol) {
+    protocolCache.erase(res);
+  }
+  forgottenProtocols.push_back(protocol);
+}
+
 uintptr_t ABIObjectiveC::fixPointer(uintptr_t ptr) const {
+  if (fixups) {
+    // NULL is never part of a chain
+    return ptr ? fixups->rebase(ptr) : 0;
+  }
+
+  // Legacy images store plain addresses, but may set the upper bits
   uintptr_t patched = ptr & ((1LLU << 51) - 1);
   if (imagebase() > 0 && patched < imagebase()) {
     patched += imagebase();
@@ -38,6 +105,170 @@ uintptr_t ABIObjectiveC::fixPointer(uintptr_t ptr) const {
   return patched;
 }
 
+uintptr_t ABIObjectiveC::fixPointerAt(uintptr_t location, uintptr_t ptr) const {
+  if (fixups) {
+    if (uintptr_t target = fixups->targetAt(location)) {
+      return target;
+    }
+  }
+  return fixPointer(ptr);
+}
+
+std::string_view ABIObjectiveC::getImportName(uintptr_t ptr) const {
+  if (fixups && ptr) {
+    if (const ChainedFixups::Import* entry = fixups->bind(ptr)) {
+      return entry->name;
+    }
+  }
+  return {};
+}
+
+std::string_view ABIObjectiveC::getImportNameAt(uintptr_t location) const {
+  if (fixups) {
+    if (const ChainedFixups::Import* entry = fixups->bindAt(location)) {
+      return entry->name;
+    }
+  } else if (imports) {
+    return imports->at(location);
+  }
+  return {};
+}
+
+std::shared_ptr<Class> ABIObjectiveC::importedClass(uintptr_t location, uintptr_t ptr) {
+  std::string_view symbol = getImportNameAt(location);
+  if (symbol.empty()) {
+    symbol = getImportName(ptr);
+  }
+
+  // Metaclasses are referenced by the superclass of other metaclasses
+  std::string_view name = symbol;
+  for (std::string_view prefix : {"_OBJC_CLASS_$_", "_OBJC_METACLASS_$_"}) {
+    if (name.substr(0, prefix.size()) == prefix) {
+      name.remove_prefix(prefix.size());
+      break;
+    }
+  }
+  if (name.size() == symbol.size()) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  std::shared_ptr<Class>& cls = importedClasses[symbol];
+  if (!cls) {
+    cls = std::make_shared<Class>();
+    cls->name = name;
+    cls->flags = 0;
+    cls->imported = true;
+  }
+  return cls;
+}
+
+const MethodTable& ABIObjectiveC::getMethodTable() const {
+  std::call_once(methodTableOnce,
+                 [this]() { methodTable = MethodTable::build(*this, *stringPool); });
+  return *methodTable;
+}
+
+const SelectorIndex& ABIObjectiveC::getSelectorIndex() const {
+  const MethodTable& table = getMethodTable();
+  std::call_once(selectorIndexOnce, [&]() { selectorIndex = SelectorIndex::build(table); });
+  return *selectorIndex;
+}
+
+std::vector<uint32_t> ABIObjectiveC::findSelector(std::string_view selector) const {
+  const SelectorIndex& index = getSelectorIndex();
+  StringPool::Handle handle;
+  if (!stringPool->find(selector, handle)) {
+    // selectors are interned while parsing, so this one is never used
+    return {};
+  }
+
+  const MethodTable::Range range = index.find(handle);
+  return std::vector<uint32_t>(index.getRows().begin() + range.begin,
+                               index.getRows().begin() + range.end);
+}
+
+const ImplementationIndex& ABIObjectiveC::getImplementationIndex() const {
+  const MethodTable& table = getMethodTable();
+  std::call_once(implementationIndexOnce, [&]() {
+    implementationIndex = ImplementationIndex::build(table, __objc_text_end(*this));
+  });
+  return *implementationIndex;
+}
+
+const Method* ABIObjectiveC::methodAt(uintptr_t address) const {
+  uint32_t row;
+  if (!getImplementationIndex().find(address, row)) {
+    return nullptr;
+  }
+  return getMethodTable().getMethods()[row];
+}
+
+const HierarchyIndex& ABIObjectiveC::getHierarchyIndex() const {
+  std::call_once(hierarchyIndexOnce, [&]() { hierarchyIndex = HierarchyIndex::build(*this); });
+  return *hierarchyIndex;
+}
+
+const ConformanceIndex& ABIObjectiveC::getConformanceIndex() const {
+  const HierarchyIndex& hierarchy = getHierarchyIndex();
+  std::call_once(conformanceIndexOnce,
+                 [&]() { conformanceIndex = ConformanceIndex::build(*this, hierarchy); });
+  return *conformanceIndex;
+}
+
+bool ABIObjectiveC::conformsTo(const Class* cls, std::string_view protocol) const {
+  const ConformanceIndex& index = getConformanceIndex();
+  return index.conformsTo(getHierarchyIndex().find(cls), index.find(protocol));
+}
+
+const std::vector<EffectiveClass>& ABIObjectiveC::getEffectiveClasses() const {
+  const HierarchyIndex& hierarchy = getHierarchyIndex();
+  const ConformanceIndex& conformance = getConformanceIndex();
+  std::call_once(effectiveClassesOnce, [&]() {
+    // categories are already joined with their base classes
+    std::vector<const Category*> categoryList;
+    for (const Category& category : getCategories()) {
+      categoryList.push_back(&category);
+    }
+
+    effectiveClasses.reserve(hierarchy.size());
+    std::vector<const Category*> attached;
+    for (uint32_t node = 0; node < hierarchy.size(); node++) {
+      const HierarchyIndex::Range range = conformance.categoriesOf(node);
+      attached.clear();
+      for (uint32_t i = range.begin; i < range.end; i++) {
+        attached.push_back(categoryList[conformance.getCategories()[i]]);
+      }
+      effectiveClasses.push_back(EffectiveClass::merge(*hierarchy.getClass(node), attached));
+    }
+  });
+  return effectiveClasses;
+}
+
+const EffectiveClass* ABIObjectiveC::getEffectiveClass(const Class* cls) const {
+  const std::vector<EffectiveClass>& views = getEffectiveClasses();
+  const uint32_t node = getHierarchyIndex().find(cls);
+  return node < views.size() ? &views[node] : nullptr;
+}
+
+std::string_view ABIObjectiveC::readString(uintptr_t address) {
+  TargetBinaryStream& current = stream();
+  if (zeroCopy) {
+    // the pool is owned by this object, which keeps the image alive
+    auto result = static_cast<ImageStream&>(current).peek_string_view(address);
+    if (!result || result->empty()) {
+      return {};
+    }
+    return stringPool->intern(*result, false);
+  }
+
+  auto result = current.peek_string_at(address);
+  if (!result || result->empty()) {
+    return {};
+  }
+  return stringPool->intern(*result);
+}
+
 const LIEF::Section* __objc_section(const ABIObjectiveC::TargetBinary& _Binary,
                                     const std::string& name) {
   for (auto& section : _Binary.sections()) {
@@ -60,58 +291,256 @@ inline const LIEF::Section* __objc_protolist(const ABIObjectiveC::TargetBinary&
   return __objc_section(_Binary, "__objc_protolist");
 }
 
-std::unique_ptr<ABIObjectiveC> ABIObjectiveC::parse(const TargetBinary& _Binary,
-                                                    std::shared_ptr<TargetBinaryStream> _Stream) {
-  auto abi = std::make_unique<ABIObjectiveC>(&_Binary, _Stream);
+/// Returns the contents of a section, preferably from the image stream.
+LIEF::span<const uint8_t> __objc_section_content(ABIObjectiveC& abi, const std::string& name) {
+  if (auto imageStream = dynamic_cast<const ImageStream*>(&abi.stream())) {
+    return imageStream->section(name);
+  }
+  if (abi.hasBinary()) {
+    if (const LIEF::Section* section = __objc_section(abi.binary(), name)) {
+      return section->content();
+    }
+  }
+  return {};
+}
 
-#define SLIST(sectionName, type, attr, attrLookup, key)                                            \
-  if (const LIEF::Section* section = __objc_section(abi->binary(), sectionName)) {                 \
-    LIEF::SpanStream list(section->content());                                                     \
-    const size_t numPtrs = list.size() / sizeof(uintptr_t);                                        \
-    for (size_t i = 0; i < numPtrs; i++) {                                                         \
-      uintptr_t location = 0;                                                                      \
-      if (auto ptr = list.read<uintptr_t>()) {                                                     \
-        location = abi->fixPointer(*ptr);                                                          \
-      } else {                                                                                     \
-        break;                                                                                     \
-      }                                                                                            \
-      if (location) {                                                                              \
-        LIEF::ScopedStream scoped(abi->stream(), location);                                        \
-        if (std::shared_ptr<type> cls = type::parse(*abi)) {                                       \
-          attrLookup[cls->key()] = cls.get();                                                      \
-          attr.push_back(std::move(cls));                                                          \
-        }                                                                                          \
-      }                                                                                            \
-    }                                                                                              \
+uintptr_t __objc_text_end(const ABIObjectiveC& abi) {
+  if (abi.hasBinary()) {
+    if (const LIEF::Section* section = __objc_section(abi.binary(), "__text")) {
+      return section->virtual_address() + section->size();
+    }
+    return 0;
+  }
+  // a separate cursor, as this may be called without a bound stream
+  if (auto image = std::dynamic_pointer_cast<ImageStream>(abi.fork())) {
+    LIEF::span<const uint8_t> text = image->section("__text");
+    if (!text.empty()) {
+      return image->address(text.data() + text.size());
+    }
   }
+  return 0;
+}
+
+std::vector<uintptr_t> __objc_list_entries(ABIObjectiveC& abi, const std::string& name) {
+  std::vector<uintptr_t> locations;
+  LIEF::span<const uint8_t> content = __objc_section_content(abi, name);
+  if (!content.empty()) {
+    LIEF::SpanStream list(content);
+    const size_t numPtrs = list.size() / sizeof(uintptr_t);
+    locations.reserve(numPtrs);
+    for (size_t i = 0; i < numPtrs; i++) {
+      auto ptr = list.read<uintptr_t>();
+      if (!ptr) {
+        break;
+      }
+      if (uintptr_t location = abi.fixPointer(*ptr)) {
+        locations.push_back(location);
+      }
+    }
+  }
+  return locations;
+}
+
+template <typename T>
+std::vector<std::shared_ptr<T>> __objc_parse_entries(ABIObjectiveC& abi,
+                                                     const std::vector<uintptr_t>& locations) {
+  // Results are stored by index, so the final order is always the order
+  // of the section - regardless of the thread that parsed an entry.
+  std::vector<std::shared_ptr<T>> results(locations.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    // Entries are claimed in small batches to balance the load.
+    constexpr size_t batchSize = 32;
+    for (size_t begin = next.fetch_add(batchSize); begin < locations.size();
+         begin = next.fetch_add(batchSize)) {
+      const size_t end = std::min(begin + batchSize, locations.size());
+      for (size_t i = begin; i < end; i++) {
+        LIEF::ScopedStream scoped(abi.stream(), locations[i]);
+        results[i] = T::parse(abi);
+      }
+    }
+  };
+
+  size_t numThreads = abi.getOptions().threads;
+  if (numThreads == 0) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  numThreads = std::min(numThreads, locations.size());
+
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < numThreads; i++) {
+    std::shared_ptr<ABIObjectiveC::TargetBinaryStream> cursor = abi.fork();
+    if (!cursor) {
+      // the stream can't be shared, parse everything on this thread
+      break;
+    }
+    workers.emplace_back([&abi, &worker, cursor]() {
+      ABIBase::ScopedCursor bound(abi, cursor);
+      worker();
+    });
+  }
+
+  worker();
+  for (std::thread& thread : workers) {
+    thread.join();
+  }
+  return results;
+}
+
+std::unique_ptr<ABIObjectiveC> ABIObjectiveC::parse(const TargetBinary& _Binary,
+                                                    std::shared_ptr<TargetBinaryStream> _Stream,
+                                                    const ParseOptions& _Options) {
+  auto abi = std::make_unique<ABIObjectiveC>(&_Binary, _Stream, _Options);
+  abi->load();
+  return abi;
+}
 
-  SLIST("__objc_classlist", umbrella::objc::Class, abi->classes, abi->classLookup, getName)
-  SLIST("__objc_catlist", umbrella::objc::Category, abi->categories, abi->categoryLookup, getName)
-  SLIST("__objc_protolist", umbrella::objc::Protocol, abi->protocols, abi->protocolLookup, getName)
+std::unique_ptr<ABIObjectiveC> ABIObjectiveC::parse(std::shared_ptr<const TargetBinary> _Binary,
+                                                    std::shared_ptr<TargetBinaryStream> _Stream,
+                                                    const ParseOptions& _Options) {
+  auto abi = std::make_unique<ABIObjectiveC>(std::move(_Binary), _Stream, _Options);
+  abi->load();
+  return abi;
+}
 
+std::unique_ptr<ABIObjectiveC> ABIObjectiveC::parse(std::shared_ptr<TargetBinaryStream> _Stream,
+                                                    const ParseOptions& _Options) {
+  if (!dynamic_cast<ImageStream*>(_Stream.get())) {
+    // sections can't be located without a binary
+    return nullptr;
+  }
+  auto abi = std::make_unique<ABIObjectiveC>(std::shared_ptr<const TargetBinary>(), _Stream,
+                                             _Options);
+  abi->load();
   return abi;
 }
 
+void ABIObjectiveC::load() {
+#define SLIST(sectionName, type, attr, attrLookup, key)                                            \
+  for (std::shared_ptr<type>& obj :                                                              \
+       __objc_parse_entries<type>(*this, __objc_list_entries(*this, sectionName))) {               \
+    if (obj) {                                                                                     \
+      attrLookup[obj->key()] = obj.get();                                                          \
+      attr.push_back(std::move(obj));                                                              \
+    }                                                                                              \
+  }
 
+  SLIST("__objc_classlist", umbrella::objc::Class, classes, classLookup, getName)
+  SLIST("__objc_catlist", umbrella::objc::Category, categories, categoryLookup, getName)
+  SLIST("__objc_protolist", umbrella::objc::Protocol, protocols, protocolLookup, getName)
+}
+
+/// Opens all supported slices of a (fat) binary.
+std::vector<std::shared_ptr<ImageStream>> __objc_images(const std::string& fileName,
+                                                        bool mapped) {
+    std::vector<std::shared_ptr<ImageStream>> images;
+    if (mapped) {
+        for (std::shared_ptr<MappedMachOStream>& stream : MappedMachOStream::open(fileName)) {
+            images.push_back(std::move(stream));
+        }
+        return images;
+    }
 
-std::unique_ptr<objc::ABIObjectiveC> parseObjC(const std::string& fileName) {
     auto fatBinary = LIEF::MachO::Parser::parse(fileName);
-    if (!fatBinary || fatBinary->empty()) {
-        return nullptr;
+    if (!fatBinary) {
+        return images;
     }
 
-    if (auto arm64 = fatBinary->take(LIEF::MachO::CPU_TYPES::CPU_TYPE_ARM64)) {
-        std::shared_ptr<MachOStream> stream = std::make_shared<MachOStream>(*arm64);
-        return objc::ABIObjectiveC::parse(*arm64, stream);
+    while (!fatBinary->empty()) {
+        std::shared_ptr<LIEF::MachO::Binary> slice = fatBinary->take(0);
+        if (!slice) {
+            break;
+        }
+        // Each stream (and its clones) shares ownership of the slice
+        auto stream = std::make_shared<MachOStream>(std::move(slice));
+        if (stream->architecture() != Architecture::UNKNOWN) {
+            images.push_back(std::move(stream));
+        }
     }
+    return images;
+}
 
-    if (auto x86_64 = fatBinary->take(LIEF::MachO::CPU_TYPES::CPU_TYPE_X86_64)) {
-        std::shared_ptr<MachOStream> stream = std::make_shared<MachOStream>(*x86_64);
-        return objc::ABIObjectiveC::parse(*x86_64, stream);
+/// Selects the slice that will be inspected if no architecture is given.
+std::shared_ptr<ImageStream> __objc_preferred(
+    const std::vector<std::shared_ptr<ImageStream>>& images) {
+    for (Architecture arch : {Architecture::ARM64, Architecture::X86_64}) {
+        for (const std::shared_ptr<ImageStream>& image : images) {
+            Architecture imageArch = image->architecture();
+            if (imageArch == Architecture::ARM64E) {
+                // any arm64 slice will do
+                imageArch = Architecture::ARM64;
+            }
+            if (imageArch == arch) {
+                return image;
+            }
+        }
     }
+    return nullptr;
+}
 
+std::unique_ptr<ABIObjectiveC> __objc_parse_image(std::shared_ptr<ImageStream> image,
+                                                  const ParseOptions& options) {
+    if (auto machoStream = std::dynamic_pointer_cast<MachOStream>(image)) {
+        return ABIObjectiveC::parse(machoStream->sharedBinary(), std::move(image), options);
+    }
+    return ABIObjectiveC::parse(std::move(image), options);
+}
+
+std::unique_ptr<objc::ABIObjectiveC> parseObjC(const std::string& fileName,
+                                               const ParseOptions& options) {
+    if (auto image = __objc_preferred(__objc_images(fileName, options.mapped))) {
+        return __objc_parse_image(std::move(image), options);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<objc::ABIObjectiveC> parseObjC(const std::string& fileName, Architecture arch,
+                                               const ParseOptions& options) {
+    for (std::shared_ptr<ImageStream>& image : __objc_images(fileName, options.mapped)) {
+        if (image->architecture() == arch) {
+            return __objc_parse_image(std::move(image), options);
+        }
+    }
     return nullptr;
 }
 
+std::vector<Slice> parseObjCSlices(const std::string& fileName, const ParseOptions& options,
+                                   bool concurrent) {
+    std::vector<std::shared_ptr<ImageStream>> images = __objc_images(fileName, options.mapped);
+    std::vector<Slice> slices(images.size());
+    auto parseSlice = [&](size_t i) {
+        slices[i].architecture = images[i]->architecture();
+        slices[i].abi = __objc_parse_image(images[i], options);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; concurrent && i < images.size(); i++) {
+        workers.emplace_back(parseSlice, i);
+    }
+    for (size_t i = 0; i < images.size(); i++) {
+        if (i == 0 || !concurrent) {
+            parseSlice(i);
+        }
+    }
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    slices.erase(std::remove_if(slices.begin(), slices.end(),
+                                [](const Slice& slice) { return !slice.abi; }),
+                 slices.end());
+    return slices;
+}
+
+bool visitObjC(const std::string& fileName, Visitor& visitor) {
+    auto image = std::dynamic_pointer_cast<MachOStream>(
+        __objc_preferred(__objc_images(fileName, false)));
+    if (!image) {
+        return false;
+    }
+    objc::visit(image->binary(), image, visitor);
+    return true;
+}
+
 } // namespace objc
 } // namespace umbrella
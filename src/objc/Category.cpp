@@ -13,7 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include <sstream>
+#include <cstddef>
 
 #include <LIEF/BinaryStream/BinaryStream.hpp>
 
@@ -33,43 +33,74 @@ namespace objc {
 
 std::shared_ptr<Category> Category::parse(ABIObjectiveC& abi) {
     LIEF::BinaryStream& stream = abi.stream();
+    CACHED(abi.categoryCache, stream.pos())
     PEEK(raw, umbrella::objc::category_t, stream)
 
     std::shared_ptr<Category> category = std::make_shared<Category>();
     category->setAddress(stream.pos());
+    std::shared_ptr<Category> interned =
+        abi.intern(category->getAddress(), abi.categoryCache, category);
+    if (interned != category) {
+        // parsed by another thread
+        return interned;
+    }
     STRING_FIXED(category->name, raw->name)
-    METHODS(raw->class_methods, category->classMethods, true)
-    METHODS(raw->instance_methods, category->instanceMethods, false)
-    PROTOCOLS(raw->base_protocols, category->baseProtocols)
-    CLASS_FIXED(raw->base_class, category->baseClass)
-    PROPERTIES(raw->instance_properties, category->instanceProperties)
+    if (abi.getOptions().lazy) {
+        category->lazyABI = &abi;
+    } else {
+        category->parseMembers(abi, *raw);
+    }
+    CLASS_FIXED(raw->base_class, category->getAddress() + offsetof(category_t, base_class),
+                category->baseClass)
     return category;
 }
 
-std::string Category::getDeclaration() const {
+void Category::parseMembers(ABIObjectiveC& abi, const category_t& raw) {
+    LIEF::BinaryStream& stream = abi.stream();
+    METHODS(raw.class_methods, classMethods, true)
+    METHODS(raw.instance_methods, instanceMethods, false)
+    PROTOCOLS(raw.base_protocols, baseProtocols)
+    PROPERTIES(raw.instance_properties, instanceProperties)
+}
+
+void Category::materialize() const {
+    if (!lazyABI) {
+        return;
+    }
+
+    std::call_once(membersOnce, [this]() {
+        lazyABI->withCursor([this]() {
+            if (auto raw = lazyABI->stream().peek<umbrella::objc::category_t>(getAddress())) {
+                const_cast<Category*>(this)->parseMembers(*lazyABI, *raw);
+            }
+        });
+    });
+}
+
+void Category::appendDeclaration(std::string& _Out) const {
     // Categories and extensions will be dumped using this method as
     // we doesn't differ between categories and extensions. Methods
     // will be devided into class and instance methods.
-    std::ostringstream stream;
-    stream << "@interface " << name << " ";
+    materialize();
+
+    _Out.append("@interface ").append(name).append(" ");
     if (isExtension()) {
-        stream << "() ";
+        _Out.append("() ");
     } else {
         // base name only if this category is a 'real' category
-        stream << "(" << baseClass->getName() << ") ";
+        _Out.append("(").append(baseClass->getName()).append(") ");
     }
 
     if (baseProtocols.size()) {
         PROTO_CONFORM_DECL(baseProtocols, "(", ")")
     }
 
-    stream << "\n";
+    _Out.append("\n");
     LIST_DECL(instanceProperties, "\n")
     LIST_DECL(instanceMethods, "\n")
     LIST_DECL(classMethods, "\n")
 
-    stream << "@end";
-    return stream.str();
+    _Out.append("@end");
 }
 
 } // namespace objc
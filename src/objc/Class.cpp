@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <deque>
+
 #include <LIEF/BinaryStream/BinaryStream.hpp>
 
 #include "umbrella/objc/ABI.h"
@@ -29,60 +31,159 @@
 namespace umbrella {
 namespace objc {
 
+namespace {
+
+/// A reference to a class that has not been resolved yet.
+struct ClassLink {
+  std::shared_ptr<Class>* slot; /**< Where the resolved class will be stored. */
+  uintptr_t address;            /**< Fixed-up address of the referenced class_t. */
+  uint32_t depth;               /**< Number of links followed from the root class. */
+};
+
+} // namespace
+
 std::shared_ptr<Class> Class::parse(ABIObjectiveC& abi) {
+  // Superclasses and metaclasses are resolved from an explicit worklist
+  // instead of recursing into this function. Each address is visited
+  // only once (see ABIObjectiveC::classCache), hence cyclic graphs and
+  // long chains in crafted binaries can't exhaust the stack.
   LIEF::BinaryStream& stream = abi.stream();
-  PEEK(raw, umbrella::objc::class_t, stream)
+  const uint32_t maxDepth = abi.getOptions().maxDepth;
 
-  std::shared_ptr<Class> cls = std::make_shared<Class>();
-  cls->setAddress(stream.pos());
-  CLASS_FIXED(raw->super_class, cls->superClass)
-  CLASS_FIXED(raw->isa, cls->metaClass)
+  std::shared_ptr<Class> root;
+  std::deque<ClassLink> pending{{&root, stream.pos(), 0}};
+  while (!pending.empty()) {
+    const ClassLink link = pending.front();
+    pending.pop_front();
+
+    if (abi.cached(link.address, abi.classCache, *link.slot)) {
+      continue;
+    }
+
+    LIEF::ScopedStream scoped(stream, link.address);
+    std::shared_ptr<Class> cls = parseData(abi);
+    if (cls && link.depth >= maxDepth) {
+      // Truncated classes are not cached: the same address may be reached
+      // again at a lower depth, where its links have to be resolved.
+      *link.slot = std::move(cls);
+      continue;
+    }
+
+    // Invalid addresses will be remembered as well. The class must be
+    // registered before following its links: the metaclass of a root
+    // class points back to itself.
+    *link.slot = abi.intern(link.address, abi.classCache, cls);
+    if (!cls || *link.slot != cls) {
+      // Another thread might have parsed the same class concurrently, its
+      // links will be resolved there.
+      continue;
+    }
+
+    if (const auto raw = stream.peek<umbrella::objc::class_t>(link.address)) {
+      // super_class directly follows the isa field of object_t. Bound
+      // pointers may be stored as 0, hence imports are checked first.
+      const uintptr_t superLocation = link.address + sizeof(object_t);
+      if (auto imported = abi.importedClass(superLocation, raw->super_class)) {
+        cls->superClass = std::move(imported);
+      } else if (raw->super_class) {
+        const uintptr_t superClass = abi.fixPointerAt(superLocation, raw->super_class);
+        if (superClass) {
+          pending.push_back({&cls->superClass, superClass, link.depth + 1});
+        }
+      }
+
+      if (auto imported = abi.importedClass(link.address, raw->isa)) {
+        cls->metaClass = std::move(imported);
+      } else if (raw->isa) {
+        const uintptr_t metaClass = abi.fixPointerAt(link.address, raw->isa);
+        if (metaClass) {
+          pending.push_back({&cls->metaClass, metaClass, link.depth + 1});
+        }
+      }
+    }
+  }
+  return root;
+}
 
-  const uintptr_t address = raw->bits.class_ro();
+std::shared_ptr<Class> Class::parseData(ABIObjectiveC& abi) {
+  LIEF::BinaryStream& stream = abi.stream();
+  const uintptr_t location = stream.pos();
+  PEEK(raw, umbrella::objc::class_t, stream)
+
+  const uintptr_t address = abi.fixPointer(raw->bits.value()) & class_data_bits_t::MASK;
   if (!address) {
     return nullptr;
   }
 
   stream.setpos(address);
   PEEK(raw_data, umbrella::objc::class_ro_t, stream);
+
+  std::shared_ptr<Class> cls = std::make_shared<Class>();
+  cls->setAddress(location);
   STRING_FIXED(cls->name, raw_data->name)
+  cls->flags = raw_data->flags;
+
+  if (abi.getOptions().lazy) {
+    cls->lazyABI = &abi;
+    cls->roAddress = address;
+  } else {
+    cls->parseMembers(abi, *raw_data);
+  }
+  return cls;
+}
 
-  PROTOCOLS(raw_data->base_protocols, cls->protocols)
-  PROPERTIES(raw_data->base_properties, cls->properties)
-  METHODS(raw_data->base_methods, cls->methods, false)
+void Class::parseMembers(ABIObjectiveC& abi, const class_ro_t& raw) {
+  LIEF::BinaryStream& stream = abi.stream();
+  PROTOCOLS(raw.base_protocols, protocols)
+  PROPERTIES(raw.base_properties, properties)
+  METHODS(raw.base_methods, methods, false)
 
-  cls->flags = raw_data->flags;
-  if (raw_data->ivars) {
+  if (raw.ivars) {
     // REVISIT: maybe put this into a macro
-    LIST(raw_data->ivars, umbrella::objc::ivar_list_t) {
+    LIST(raw.ivars, umbrella::objc::ivar_list_t) {
       const size_t size = sizeof(ivar_t);
       const size_t baseAddress = stream.pos();
 
       for (size_t i = 0; i < list->count; i++) {
         stream.setpos(baseAddress + i * size);
-        if (auto ivar = IVar::parse(abi)) {
-          cls->ivars.push_back(std::move(ivar));
+        if (IVar* ivar = IVar::parse(abi)) {
+          ivars.push_back(std::move(ivar));
         }
       }
     }
   }
+}
 
-  return cls;
+void Class::materialize() const {
+  if (!lazyABI) {
+    return;
+  }
+
+  std::call_once(membersOnce, [this]() {
+    lazyABI->withCursor([this]() {
+      if (auto raw = lazyABI->stream().peek<umbrella::objc::class_ro_t>(roAddress)) {
+        const_cast<Class*>(this)->parseMembers(*lazyABI, *raw);
+      }
+    });
+  });
 }
 
-std::string Class::getDeclaration() const {
+void Class::appendDeclaration(std::string& _Out) const {
   // Dumping a class is somewhat more comlicated, but can be broken
   // down into pieces. As classes may contain a metaclass (a class
   // that stores all 'static'/class methods, properties and ivars),
   // these attributes have to be dumped as well.
-  std::ostringstream stream;
-  std::string superClassName = "NSObject";
+  materialize();
+  if (hasMetaClass()) {
+    metaClass->materialize();
+  }
 
+  _Out.append("@interface ").append(name);
   if (hasSuperClass()) {
-    superClassName = superClass->getName();
+    // imported superclasses are resolved by their symbol name
+    _Out.append(": ").append(superClass->getName());
   }
-
-  stream << "@interface " << name << ": " << superClassName << " ";
+  _Out.append(" ");
   if (protocols.size()) {
     // REVISIT: these names have to be demangled
     PROTO_CONFORM_DECL(protocols, "<", ">")
@@ -96,14 +197,14 @@ std::string Class::getDeclaration() const {
   const bool hasIvars = ivars.size() || (hasMetaClass() && metaClass->ivars.size());
   if (hasIvars) {
     // ivars will be placed into a block
-    stream << "\n{";
+    _Out.append("\n{");
   }
 
-  stream << "\n";
+  _Out.append("\n");
   LIST_DECL(ivars, "\n")
   META_LIST_DECL(metaClass->ivars)
   if (hasIvars) {
-    stream << "}\n";
+    _Out.append("}\n");
   }
 
   // Properties
@@ -114,8 +215,7 @@ std::string Class::getDeclaration() const {
   LIST_DECL(methods, "\n")
   META_LIST_DECL(metaClass->methods)
 
-  stream << "@end";
-  return stream.str();
+  _Out.append("@end");
 }
 
 } // namespace objc
@@ -0,0 +1,178 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "umbrella/objc/ABI.h"
+#include "umbrella/objc/Category.h"
+#include "umbrella/objc/Class.h"
+#include "umbrella/objc/ConformanceIndex.h"
+#include "umbrella/objc/Protocol.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+uint32_t ConformanceIndex::intern(const Protocol& protocol) {
+  // protocols are unique by name, the same protocol may be emitted by
+  // several images or twice into the same one
+  auto result = lookup.emplace(protocol.getName(), static_cast<uint32_t>(protocols.size()));
+  if (result.second) {
+    protocols.push_back(&protocol);
+  }
+  return result.first->second;
+}
+
+std::unique_ptr<ConformanceIndex> ConformanceIndex::build(const ABIObjectiveC& abi,
+                                                          const HierarchyIndex& hierarchy) {
+  std::unique_ptr<ConformanceIndex> index(new ConformanceIndex());
+
+  // Assign IDs to all protocols, including the ones only reachable
+  // through adopted protocols. Edges are kept to compute the closure.
+  std::vector<std::vector<uint32_t>> adopted;
+  std::vector<const Protocol*> pending;
+  for (const Protocol& protocol : abi.getProtocols()) {
+    pending.push_back(&protocol);
+  }
+  for (const Class* cls : hierarchy.getClasses()) {
+    for (const Protocol& protocol : cls->getProtocols()) {
+      pending.push_back(&protocol);
+    }
+  }
+  for (const Category& category : abi.getCategories()) {
+    for (const Protocol& protocol : category.getBaseProtocols()) {
+      pending.push_back(&protocol);
+    }
+  }
+  while (!pending.empty()) {
+    const Protocol* protocol = pending.back();
+    pending.pop_back();
+    const size_t known = index->protocols.size();
+    const uint32_t id = index->intern(*protocol);
+    if (id < known) {
+      continue;
+    }
+    adopted.emplace_back();
+    for (const Protocol& other : protocol->getProtocols()) {
+      pending.push_back(&other);
+    }
+  }
+  for (uint32_t id = 0; id < index->protocols.size(); id++) {
+    for (const Protocol& other : index->protocols[id]->getProtocols()) {
+      adopted[id].push_back(index->lookup[other.getName()]);
+    }
+  }
+
+  const size_t count = index->protocols.size();
+  const size_t words = (count + 63) / 64;
+  index->words = words;
+  auto orRow = [words](uint64_t* target, const uint64_t* source) {
+    for (size_t word = 0; word < words; word++) {
+      target[word] |= source[word];
+    }
+  };
+  auto setBit = [](uint64_t* row, uint32_t id) { row[id / 64] |= uint64_t(1) << (id % 64); };
+
+  // Protocol closure, iterated until it is stable. Adoption chains are
+  // short, so this converges after a few rounds (and terminates on cycles).
+  index->protocolBits.assign(count * words, 0);
+  for (uint32_t id = 0; id < count; id++) {
+    setBit(&index->protocolBits[id * words], id);
+  }
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (uint32_t id = 0; id < count; id++) {
+      uint64_t* row = &index->protocolBits[id * words];
+      for (uint32_t other : adopted[id]) {
+        const uint64_t* source = &index->protocolBits[other * words];
+        for (size_t word = 0; word < words; word++) {
+          if (source[word] & ~row[word]) {
+            row[word] |= source[word];
+            changed = true;
+          }
+        }
+      }
+    }
+  }
+
+  // Join categories with the nodes of their base classes
+  const uint32_t nodes = static_cast<uint32_t>(hierarchy.size());
+  std::vector<uint32_t> categoryNodes;
+  index->categoryOffsets.assign(nodes + 1, 0);
+  for (const Category& category : abi.getCategories()) {
+    const uint32_t node = hierarchy.find(category.getBaseClass());
+    categoryNodes.push_back(node);
+    if (node != HierarchyIndex::NONE) {
+      index->categoryOffsets[node + 1]++;
+    }
+  }
+  for (uint32_t node = 0; node < nodes; node++) {
+    index->categoryOffsets[node + 1] += index->categoryOffsets[node];
+  }
+  index->categories.resize(index->categoryOffsets[nodes]);
+  std::vector<uint32_t> cursor(index->categoryOffsets.begin(), index->categoryOffsets.end() - 1);
+  for (uint32_t category = 0; category < categoryNodes.size(); category++) {
+    if (categoryNodes[category] != HierarchyIndex::NONE) {
+      index->categories[cursor[categoryNodes[category]]++] = category;
+    }
+  }
+
+  // Class rows, superclasses come first in pre-order
+  std::vector<const Category*> categoryList;
+  for (const Category& category : abi.getCategories()) {
+    categoryList.push_back(&category);
+  }
+  index->classBits.assign(static_cast<size_t>(nodes) * words, 0);
+  for (uint32_t node = 0; node < nodes; node++) {
+    uint64_t* row = &index->classBits[node * words];
+    const uint32_t parent = hierarchy.getParent(node);
+    if (parent != HierarchyIndex::NONE) {
+      orRow(row, &index->classBits[parent * words]);
+    }
+    for (const Protocol& protocol : hierarchy.getClass(node)->getProtocols()) {
+      orRow(row, &index->protocolBits[index->lookup[protocol.getName()] * words]);
+    }
+    const HierarchyIndex::Range range = index->categoriesOf(node);
+    for (uint32_t i = range.begin; i < range.end; i++) {
+      for (const Protocol& protocol : categoryList[index->categories[i]]->getBaseProtocols()) {
+        orRow(row, &index->protocolBits[index->lookup[protocol.getName()] * words]);
+      }
+    }
+  }
+  return index;
+}
+
+uint32_t ConformanceIndex::find(std::string_view name) const {
+  auto result = lookup.find(name);
+  return result != lookup.end() ? result->second : NONE;
+}
+
+std::vector<uint32_t> ConformanceIndex::conformingClasses(uint32_t protocol) const {
+  std::vector<uint32_t> result;
+  if (protocol >= protocols.size()) {
+    return result;
+  }
+  // scans a single column of the class bitsets
+  const size_t word = protocol / 64;
+  const uint64_t mask = uint64_t(1) << (protocol % 64);
+  const size_t count = getClassCount();
+  for (size_t node = 0; node < count; node++) {
+    if (classBits[node * words + word] & mask) {
+      result.push_back(static_cast<uint32_t>(node));
+    }
+  }
+  return result;
+}
+
+} // namespace objc
+} // namespace umbrella
@@ -16,24 +16,43 @@
 #if !defined(__UMBRELLA_PRIVATE_DECLARATION_H__)
 #define __UMBRELLA_PRIVATE_DECLARATION_H__
 
+#include <charconv>
+#include <cstdint>
+#include <string>
+
+// Declarations are appended to the caller's buffer, named _Out
 #define LIST_DECL(var_name, END)                                                                   \
   if (var_name.size()) {                                                                           \
-    stream << ("// " #var_name) << "\n";                                                           \
+    _Out.append("// " #var_name "\n");                                                             \
     for (auto _elem : var_name) {                                                                  \
-      stream << _elem->getDeclaration() << "\n";                                                   \
+      _elem->appendDeclaration(_Out);                                                              \
+      _Out.push_back('\n');                                                                        \
     }                                                                                              \
-    stream << END;                                                                                \
+    _Out.append(END);                                                                              \
   }
 
 #define PROTO_CONFORM_DECL(var_name, start, end)                                                   \
-  stream << start;                                                                                 \
+  _Out.append(start);                                                                              \
   const auto count = var_name.size();                                                              \
   for (size_t i = 0; i < count; i++) {                                                             \
-    stream << var_name[i]->getName();                                                              \
+    _Out.append(var_name[i]->getName());                                                           \
     if (i < (count - 1)) {                                                                         \
-      stream << ", ";                                                                              \
+      _Out.append(", ");                                                                           \
     }                                                                                              \
   }                                                                                                \
-  stream << (end " ");
+  _Out.append(end " ");
+
+namespace umbrella {
+namespace objc {
+
+// Appends a number without going through a stream
+inline void appendNumber(std::string& _Out, uint64_t value, int base = 10) {
+  char buffer[24];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, base);
+  _Out.append(buffer, result.ptr);
+}
+
+} // namespace objc
+} // namespace umbrella
 
 #endif  // __UMBRELLA_PRIVATE_DECLARATION_H__
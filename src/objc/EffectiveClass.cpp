@@ -0,0 +1,72 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string_view>
+#include <unordered_set>
+
+#include "umbrella/objc/EffectiveClass.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+EffectiveClass EffectiveClass::merge(const Class& cls,
+                                     const std::vector<const Category*>& categories) {
+  EffectiveClass view;
+  view.cls = &cls;
+
+  // The runtime prepends category lists to the class, the category
+  // attached last ends up in front.
+  std::unordered_set<std::string_view> seen;
+  auto addProtocols = [&](auto protocols) {
+    for (Protocol& protocol : protocols) {
+      if (seen.insert(protocol.getName()).second) {
+        view.protocols.push_back(&protocol);
+      }
+    }
+  };
+
+  for (auto it = categories.rbegin(); it != categories.rend(); ++it) {
+    const Category& category = **it;
+    view.categories.push_back(const_cast<Category*>(&category));
+    for (Method& method : category.getInstanceMethods()) {
+      view.methods.push_back(&method);
+    }
+    for (Method& method : category.getClassMethods()) {
+      view.classMethods.push_back(&method);
+    }
+    for (Property& property : category.getInstanceProperties()) {
+      view.properties.push_back(&property);
+    }
+    addProtocols(category.getBaseProtocols());
+  }
+
+  for (Method& method : cls.getMethods()) {
+    view.methods.push_back(&method);
+  }
+  if (const Class* meta = cls.getMetaClass()) {
+    for (Method& method : meta->getMethods()) {
+      view.classMethods.push_back(&method);
+    }
+  }
+  for (Property& property : cls.getProperties()) {
+    view.properties.push_back(&property);
+  }
+  addProtocols(cls.getProtocols());
+  return view;
+}
+
+} // namespace objc
+} // namespace umbrella
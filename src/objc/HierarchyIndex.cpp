@@ -0,0 +1,165 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <utility>
+
+#include "umbrella/objc/ABI.h"
+#include "umbrella/objc/Category.h"
+#include "umbrella/objc/Class.h"
+#include "umbrella/objc/HierarchyIndex.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+std::unique_ptr<HierarchyIndex> HierarchyIndex::build(const ABIObjectiveC& abi) {
+  // Collect all classes and their superclasses, numbered in the order
+  // they are found. Superclasses outside of the class list (imported
+  // placeholders) and the base classes of categories become nodes as well.
+  std::vector<const Class*> found;
+  std::unordered_map<const Class*, uint32_t> ids;
+  auto add = [&](const Class* cls) {
+    auto result = ids.emplace(cls, static_cast<uint32_t>(found.size()));
+    if (result.second) {
+      found.push_back(cls);
+    }
+    return result.second;
+  };
+
+  auto addChain = [&](const Class* current) {
+    // stops at the first class that is already known
+    while (current && add(current)) {
+      current = current->getSuperClass();
+    }
+  };
+  for (const Class& cls : abi.getClasses()) {
+    addChain(&cls);
+  }
+  for (const Category& category : abi.getCategories()) {
+    addChain(category.getBaseClass());
+  }
+
+  const uint32_t count = static_cast<uint32_t>(found.size());
+  std::vector<uint32_t> parentIds(count, NONE);
+  std::vector<uint32_t> childCounts(count + 1, 0);
+  for (uint32_t id = 0; id < count; id++) {
+    if (const Class* super = found[id]->getSuperClass()) {
+      parentIds[id] = ids[super];
+      childCounts[parentIds[id]]++;
+    }
+  }
+
+  // children by id in CSR form, ordered by id
+  std::vector<uint32_t> offsets(count + 1, 0);
+  for (uint32_t id = 0; id < count; id++) {
+    offsets[id + 1] = offsets[id] + childCounts[id];
+  }
+  std::vector<uint32_t> childIds(offsets[count]);
+  std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+  for (uint32_t id = 0; id < count; id++) {
+    if (parentIds[id] != NONE) {
+      childIds[cursor[parentIds[id]]++] = id;
+    }
+  }
+
+  std::unique_ptr<HierarchyIndex> index(new HierarchyIndex());
+  index->classes.reserve(count);
+  index->parents.assign(count, NONE);
+  index->depths.assign(count, 0);
+  index->ends.assign(count, 0);
+
+  // Iterative pre-order traversal. Roots are classes without superclass;
+  // nodes left over afterwards are part of a cycle or hang off one. Each
+  // cycle is entered at one of its members, which drops the link to that
+  // member's superclass only.
+  std::vector<uint32_t> nodes(count, NONE);
+  std::vector<std::pair<uint32_t, uint32_t>> stack; // (id, next child)
+  auto visit = [&](uint32_t root) {
+    auto enter = [&](uint32_t id, uint32_t parent) {
+      const uint32_t node = static_cast<uint32_t>(index->classes.size());
+      nodes[id] = node;
+      index->classes.push_back(found[id]);
+      index->parents[node] = parent;
+      index->depths[node] = parent == NONE ? 0 : index->depths[parent] + 1;
+      stack.emplace_back(id, offsets[id]);
+    };
+
+    enter(root, NONE);
+    while (!stack.empty()) {
+      auto& top = stack.back();
+      if (top.second == offsets[top.first + 1]) {
+        index->ends[nodes[top.first]] = static_cast<uint32_t>(index->classes.size());
+        stack.pop_back();
+        continue;
+      }
+      const uint32_t child = childIds[top.second++];
+      if (nodes[child] == NONE) {
+        enter(child, nodes[top.first]);
+      }
+    }
+  };
+
+  for (uint32_t id = 0; id < count; id++) {
+    if (parentIds[id] == NONE) {
+      visit(id);
+    }
+  }
+  std::vector<uint32_t> marks(count, NONE);
+  for (uint32_t id = 0; id < count; id++) {
+    if (nodes[id] != NONE) {
+      continue;
+    }
+    // superclasses of a leftover node never reach a root, thus following
+    // them ends on a cycle
+    uint32_t member = id;
+    while (marks[member] != id && parentIds[member] != NONE) {
+      marks[member] = id;
+      member = parentIds[member];
+    }
+    visit(member);
+  }
+
+  // direct subclasses by node, in pre-order
+  index->childOffsets.assign(count + 1, 0);
+  for (uint32_t node = 0; node < count; node++) {
+    if (index->parents[node] != NONE) {
+      index->childOffsets[index->parents[node] + 1]++;
+    }
+  }
+  for (uint32_t node = 0; node < count; node++) {
+    index->childOffsets[node + 1] += index->childOffsets[node];
+  }
+  index->children.resize(index->childOffsets[count]);
+  cursor.assign(index->childOffsets.begin(), index->childOffsets.end() - 1);
+  for (uint32_t node = 0; node < count; node++) {
+    if (index->parents[node] != NONE) {
+      index->children[cursor[index->parents[node]]++] = node;
+    }
+  }
+
+  index->lookup.reserve(count);
+  for (uint32_t node = 0; node < count; node++) {
+    index->lookup.emplace(index->classes[node], node);
+  }
+  return index;
+}
+
+uint32_t HierarchyIndex::find(const Class* cls) const {
+  auto result = lookup.find(cls);
+  return result != lookup.end() ? result->second : NONE;
+}
+
+} // namespace objc
+} // namespace umbrella
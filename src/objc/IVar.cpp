@@ -13,7 +13,6 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include <sstream>
 #include <cctype>
 
 #include <LIEF/BinaryStream/BinaryStream.hpp>
@@ -22,16 +21,17 @@
 #include "umbrella/objc/IVar.h"
 #include "umbrella/visibility.h"
 
+#include "objc/Declaration.h"
 #include "objc/Parsing.h"
 
 namespace umbrella {
 namespace objc {
 
-std::shared_ptr<IVar> IVar::parse(ABIObjectiveC& abi) {
+IVar* IVar::parse(ABIObjectiveC& abi) {
   LIEF::BinaryStream& stream = abi.stream();
   PEEK(raw, umbrella::objc::ivar_t, stream)
 
-  std::shared_ptr<IVar> ivar = std::make_shared<IVar>();
+  IVar* ivar = abi.arena.create<IVar>();
   ivar->setAddress(stream.pos());
   ivar->alignment = raw->alignment;
   ivar->size = raw->size;
@@ -48,44 +48,41 @@ std::shared_ptr<IVar> IVar::parse(ABIObjectiveC& abi) {
   return ivar;
 }
 
-std::string IVar::getDeclaration() const {
+void IVar::appendDeclaration(std::string& _Out) const {
   // As Ivars are not that complicated, the structure of a dumped Ivar
   // is rather simple:
   //   - <ivar> := <type> <name>';'
-  std::ostringstream stream;
   if (name.empty() || typeName.empty()) {
     // we are dealing with a remapped type (address is relocated - NOT IMPLEMENTED)
-    stream << "// 0x" << std::hex << getAddress() << " <remapped>";
+    _Out.append("// 0x");
+    appendNumber(_Out, getAddress(), 16);
+    _Out.append(" <remapped>");
   }
 
   else {
-    try {
-      std::shared_ptr<TypeNode> typeDesc = objc::typedesc(typeName);
-      if (!typeDesc) {
-        stream << "// 0x" << std::hex << getAddress() << " <invalid type> '" << typeName << "'";
-      } else {
-        stream << objc::decode(*typeDesc);
-        // NOTE: In some cases, especially when dumping basic ivars with a
-        // protocol, the name may be hardcoded into the property's attributes.
-        // Therefore, we have to check whether the name is already present in
-        // the encoded type description.
-        auto result = typeName.find(name);
-        if (result == std::string::npos) {
-            if (std::isprint(name[0])) {
-              stream << " " << name;
-            } else {
-              stream << " _$remapped_name";
-            }
+    const size_t begin = _Out.size();
+    TypeCache::global().appendDecoded(typeName, _Out);
+    if (_Out.size() == begin) {
+      // malformed encodings are decoded to an empty string
+      _Out.append("// 0x");
+      appendNumber(_Out, getAddress(), 16);
+      _Out.append(" <invalid type> '").append(typeName).append("'");
+    } else {
+      // NOTE: In some cases, especially when dumping basic ivars with a
+      // protocol, the name may be hardcoded into the property's attributes.
+      // Therefore, we have to check whether the name is already present in
+      // the encoded type description.
+      auto result = typeName.find(name);
+      if (result == std::string::npos) {
+        if (std::isprint(name[0])) {
+          _Out.append(" ").append(name);
+        } else {
+          _Out.append(" _$remapped_name");
         }
-        stream << ";";
       }
-    } catch (const std::out_of_range& err) {
-       // ignore and print remapped
-       stream << "// 0x" << std::hex << getAddress() << " <remapped, invalid type>";
+      _Out.append(";");
     }
   }
-
-  return stream.str();
 }
 
 } // namespace objc
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <utility>
+
+#include "umbrella/objc/ImplementationIndex.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+std::unique_ptr<ImplementationIndex> ImplementationIndex::build(const MethodTable& table,
+                                                                uintptr_t textEnd) {
+  const std::vector<uintptr_t>& implementations = table.getImplementations();
+  std::vector<std::pair<uintptr_t, uint32_t>> entries;
+  entries.reserve(implementations.size());
+  for (size_t row = 0; row < implementations.size(); row++) {
+    if (implementations[row]) {
+      entries.emplace_back(implementations[row], static_cast<uint32_t>(row));
+    }
+  }
+  // sorting by (address, row) keeps the first row of shared implementations
+  std::sort(entries.begin(), entries.end());
+
+  std::unique_ptr<ImplementationIndex> index(new ImplementationIndex());
+  index->addresses.reserve(entries.size());
+  index->rows.reserve(entries.size());
+  for (const auto& entry : entries) {
+    if (!index->addresses.empty() && index->addresses.back() == entry.first) {
+      continue;
+    }
+    index->addresses.push_back(entry.first);
+    index->rows.push_back(entry.second);
+  }
+
+  if (!index->addresses.empty()) {
+    // implementations outside of __text (or an unknown section end) only
+    // cover their own address
+    const uintptr_t last = index->addresses.back();
+    index->end = textEnd > last ? textEnd : last + 1;
+  }
+  return index;
+}
+
+bool ImplementationIndex::find(uintptr_t address, uint32_t& row) const {
+  // the addresses are kept apart from the rows, so the search only touches
+  // the column it compares against
+  auto it = std::upper_bound(addresses.begin(), addresses.end(), address);
+  if (it == addresses.begin() || address >= end) {
+    return false;
+  }
+  row = rows[static_cast<size_t>(it - addresses.begin()) - 1];
+  return true;
+}
+
+} // namespace objc
+} // namespace umbrella
@@ -14,70 +14,68 @@
  * limitations under the License.
  */
 #include <LIEF/BinaryStream/BinaryStream.hpp>
-#include <sstream>
 
 #include "umbrella/objc/ABI.h"
 #include "umbrella/objc/Method.h"
 #include "umbrella/visibility.h"
 
+#include "objc/Declaration.h"
 #include "objc/Parsing.h"
 
 namespace umbrella {
 namespace objc {
 
-std::shared_ptr<Method> Method::parse(ABIObjectiveC& abi, bool isSmall, bool isClassMethod) {
+Method* Method::parse(ABIObjectiveC& abi, bool isSmall, bool isClassMethod) {
     LIEF::BinaryStream& stream = abi.stream();
-    std::shared_ptr<Method> method = std::make_shared<Method>();
-
-    method->setAddress(stream.pos());
-    method->classMethod = isClassMethod;
-    method->relativeMethod = isSmall;
     if (isSmall) {
         PEEK(raw, umbrella::objc::small_method_t, stream)
 
-        if (auto result = stream.peek<uintptr_t>(method->applyRelativeOffset(raw->name))) {
-            const uintptr_t ptr = abi.fixPointer(*result);
-            if (auto res = stream.peek_string_at(ptr)) {
-                method->name = std::move(*res);
-            }
+        Method* method = abi.arena.create<Method>();
+        method->setAddress(stream.pos());
+        method->classMethod = isClassMethod;
+        method->relativeMethod = true;
+
+        // the name is stored in a selref, which may be bound or chained
+        const uintptr_t selref = method->applyRelativeOffset(raw->name);
+        if (auto result = stream.peek<uintptr_t>(selref)) {
+            method->name = abi.readString(abi.fixPointerAt(selref, *result));
         }
 
         const size_t offset = offsetof(umbrella::objc::small_method_t, signature);
-        if (auto result =
-                stream.peek_string_at(method->applyRelativeOffset(offset + raw->signature))) {
-            method->signature = std::move(*result);
-        }
+        STRING(method->signature, method->applyRelativeOffset(offset + raw->signature))
         method->relImpl = raw->impl;
-    } else {
-        PEEK(raw, umbrella::objc::big_method_t, stream)
-
-        STRING_FIXED(method->name, raw->name)
-        STRING_FIXED(method->signature, raw->signature)
-        method->absImpl = raw->impl;
+        return method;
     }
 
+    PEEK(raw, umbrella::objc::big_method_t, stream)
+
+    Method* method = abi.arena.create<Method>();
+    method->setAddress(stream.pos());
+    method->classMethod = isClassMethod;
+    method->relativeMethod = false;
+    STRING_FIXED(method->name, raw->name)
+    STRING_FIXED(method->signature, raw->signature)
+    method->absImpl = raw->impl;
     return method;
 }
 
-std::string Method::getDeclaration() const {
+void Method::appendDeclaration(std::string& _Out) const {
     // Methods will be dumped with their signature and selector combined.
     //   - <method> := [ '+' | '-' ] <signature>
-    std::ostringstream stream;
-
-    std::string signature = std::move(decodeSignature());
     if (isClassMethod()) {
         // Class methods will be annotated with a '+'
-        stream << "+ ";
+        _Out.append("+ ");
     } else {
-        stream << "- ";
+        _Out.append("- ");
     }
+    TypeCache::global().appendSignature(getName(), getSignature(), _Out);
 
     uintptr_t impl = getImplementation();
     if (isSmallMethod()) {
         impl = getRelativeImplementation();
     }
-    stream << signature << " // 0x" << std::hex << impl;
-    return stream.str();
+    _Out.append(" // 0x");
+    appendNumber(_Out, impl, 16);
 }
 
 } // namespace objc
@@ -0,0 +1,110 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstddef>
+
+#include "umbrella/objc/ABI.h"
+#include "umbrella/objc/Category.h"
+#include "umbrella/objc/Class.h"
+#include "umbrella/objc/Method.h"
+#include "umbrella/objc/MethodTable.h"
+#include "umbrella/objc/Protocol.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+void MethodTable::add(const ABIObjectiveC& abi, StringPool& pool, const Method& method, OwnerKind kind,
+                      uint32_t owner, uint8_t methodFlags) {
+  uintptr_t impl = 0;
+  if (method.isSmallMethod()) {
+    // relative to the impl field of the small_method_t
+    const int32_t offset = static_cast<int32_t>(offsetof(small_method_t, impl));
+    impl = method.getRelativeImplementation()
+               ? method.applyRelativeOffset(offset + method.getRelativeImplementation())
+               : 0;
+    methodFlags |= SMALL_METHOD;
+  } else if (method.getImplementation()) {
+    impl = abi.fixPointer(method.getImplementation());
+  }
+
+  // All strings are interned already, which makes these plain lookups
+  ownerKinds.push_back(kind);
+  owners.push_back(owner);
+  selectors.push_back(pool.add(method.getName(), false));
+  signatures.push_back(pool.add(method.getSignature(), false));
+  implementations.push_back(impl);
+  flags.push_back(methodFlags);
+  methods.push_back(&method);
+}
+
+std::unique_ptr<MethodTable> MethodTable::build(const ABIObjectiveC& abi, StringPool& pool) {
+  std::unique_ptr<MethodTable> table(new MethodTable());
+
+#define ADD_METHODS(list, kind, flags)                                                             \
+  for (const Method& method : list) {                                                              \
+    table->add(abi, pool, method, kind, index, flags);                                             \
+  }
+
+  uint32_t index = 0;
+  for (const Class& cls : abi.getClasses()) {
+    const uint32_t begin = static_cast<uint32_t>(table->size());
+    ADD_METHODS(cls.getMethods(), CLASS, 0)
+    if (const Class* meta = cls.getMetaClass()) {
+      // class methods are stored in the metaclass
+      ADD_METHODS(meta->getMethods(), CLASS, CLASS_METHOD)
+    }
+    table->classRanges.push_back({begin, static_cast<uint32_t>(table->size())});
+    index++;
+  }
+
+  index = 0;
+  for (const Category& category : abi.getCategories()) {
+    const uint32_t begin = static_cast<uint32_t>(table->size());
+    ADD_METHODS(category.getInstanceMethods(), CATEGORY, 0)
+    ADD_METHODS(category.getClassMethods(), CATEGORY, CLASS_METHOD)
+    table->categoryRanges.push_back({begin, static_cast<uint32_t>(table->size())});
+    index++;
+  }
+
+  index = 0;
+  for (const Protocol& protocol : abi.getProtocols()) {
+    const uint32_t begin = static_cast<uint32_t>(table->size());
+    ADD_METHODS(protocol.getRequiredInstanceMethods(), PROTOCOL, 0)
+    ADD_METHODS(protocol.getRequiredClassMethods(), PROTOCOL, CLASS_METHOD)
+    ADD_METHODS(protocol.getOptionalInstanceMethods(), PROTOCOL, OPTIONAL)
+    ADD_METHODS(protocol.getOptionalClassMethods(), PROTOCOL, CLASS_METHOD | OPTIONAL)
+    table->protocolRanges.push_back({begin, static_cast<uint32_t>(table->size())});
+    index++;
+  }
+
+#undef ADD_METHODS
+  return table;
+}
+
+MethodTable::Range MethodTable::ofClass(size_t index) const {
+  return index < classRanges.size() ? classRanges[index] : Range{0, 0};
+}
+
+MethodTable::Range MethodTable::ofCategory(size_t index) const {
+  return index < categoryRanges.size() ? categoryRanges[index] : Range{0, 0};
+}
+
+MethodTable::Range MethodTable::ofProtocol(size_t index) const {
+  return index < protocolRanges.size() ? protocolRanges[index] : Range{0, 0};
+}
+
+} // namespace objc
+} // namespace umbrella
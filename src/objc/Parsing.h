@@ -16,15 +16,26 @@
 #if !defined(__UMBRELLA_PRIVATE_PARSING_H__)
 #define __UMBRELLA_PRIVATE_PARSING_H__
 
-#define STRING_FIXED(attr, raw_attr)                                                               \
-    if (auto result = stream.peek_string_at(abi.fixPointer(raw_attr))) {                           \
-        attr = std::move(*result);                                                                 \
-    }
+#include <string>
+#include <vector>
 
-#define STRING(attr, raw_attr)                                                                     \
-    if (auto result = stream.peek_string_at(raw_attr)) {                                           \
-        attr = std::move(*result);                                                                 \
-    }
+namespace umbrella {
+namespace objc {
+
+class ABIObjectiveC;
+
+/// Returns the fixed-up locations stored in an __objc_*list section.
+std::vector<uintptr_t> __objc_list_entries(ABIObjectiveC& abi, const std::string& name);
+
+/// Returns the end address of the __text section, 0 if it is unknown.
+uintptr_t __objc_text_end(const ABIObjectiveC& abi);
+
+} // namespace objc
+} // namespace umbrella
+
+#define STRING_FIXED(attr, raw_attr) attr = abi.readString(abi.fixPointer(raw_attr));
+
+#define STRING(attr, raw_attr) attr = abi.readString(raw_attr);
 
 #define PEEK(var_name, type, stream_var)                                                           \
     const auto var_name = stream_var.peek<type>();                                                 \
@@ -32,6 +43,14 @@
         return nullptr;                                                                            \
     }
 
+#define CACHED(cache, address)                                                                     \
+    {                                                                                              \
+        decltype(cache)::mapped_type cached_;                                                      \
+        if (abi.cached(address, cache, cached_)) {                                                 \
+            return cached_;                                                                        \
+        }                                                                                          \
+    }
+
 #define LIST(var, type)                                                                            \
     LIEF::ScopedStream scoped(stream, var);                                                        \
     if (const auto list = stream.read<type>())
@@ -44,8 +63,8 @@
             const size_t baseAddress = stream.pos();                                               \
             for (size_t i = 0; i < list->count; i++) {                                             \
                 stream.setpos(baseAddress + i * size);                                             \
-                if (std::shared_ptr<Method> method = Method::parse(abi, isSmall, isClass)) {       \
-                    attr.push_back(std::move(method));                                             \
+                if (Method* method = Method::parse(abi, isSmall, isClass)) {                     \
+                    attr.push_back(method);                                                        \
                 }                                                                                  \
             }                                                                                      \
         }                                                                                          \
@@ -76,16 +95,18 @@
             const size_t baseAddress = stream.pos();                                               \
             for (size_t i = 0; i < list->count; i++) {                                             \
                 stream.setpos(baseAddress + i * size);                                             \
-                if (std::shared_ptr<Property> prop = Property::parse(abi)) {                       \
-                    attr.push_back(std::move(prop));                                               \
+                if (Property* prop = Property::parse(abi)) {                                       \
+                    attr.push_back(prop);                                                          \
                 }                                                                                  \
             }                                                                                      \
         }                                                                                          \
     }
 
-#define CLASS_FIXED(var, attr)                                                                     \
-    if (var) {                                                                                     \
-        stream.setpos(abi.fixPointer(var));                                                        \
+#define CLASS_FIXED(var, location, attr)                                                           \
+    if (auto imported_ = abi.importedClass(location, var)) {                                       \
+        attr = std::move(imported_);                                                               \
+    } else if (var) {                                                                              \
+        stream.setpos(abi.fixPointerAt(location, var));                                            \
         if (auto cls_ = Class::parse(abi)) {                                                       \
             attr = std::move(cls_);                                                                \
         }                                                                                          \
@@ -24,34 +24,32 @@
 namespace umbrella {
 namespace objc {
 
-std::shared_ptr<Property> Property::parse(ABIObjectiveC& abi) {
+Property* Property::parse(ABIObjectiveC& abi) {
     LIEF::BinaryStream& stream = abi.stream();
     PEEK(raw, umbrella::objc::property_t, stream)
 
-    std::shared_ptr<Property> property = std::make_shared<Property>();
+    Property* property = abi.arena.create<Property>();
     property->setAddress(stream.pos());
     STRING_FIXED(property->name, raw->name)
     STRING_FIXED(property->attributes, raw->attributes)
     return property;
 }
 
-std::string Property::getDeclaration() const {
+void Property::appendDeclaration(std::string& _Out) const {
     // Properties will be treated like Ivars. Note that we don't assume any
     // remapped type names.
     //   - <property> := '@property' [ <attributes> ] <type> <name>
-    std::ostringstream stream;
-    std::string attributes = std::move(decodeAttributes());
+    const size_t begin = _Out.size();
+    TypeCache::global().appendDecoded(getAttributes(), _Out);
 
-    stream << attributes;
-    auto result = attributes.find(name);
+    auto result = _Out.find(name, begin);
     if (result == std::string::npos) {
         // NOTE: In some cases, especially when dumping root properties,
         // the name may be hardcoded into the property's attributes. Therefore,
         // we have to check whether the name is already present in the encoded
         // type description.
-        stream << " " << name;
+        _Out.append(" ").append(name);
     }
-    return stream.str();
 }
 
 } // namespace objc
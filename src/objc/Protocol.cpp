@@ -24,59 +24,117 @@
 #include "objc/Declaration.h"  // private include
 #include "objc/Parsing.h"      // private include
 
-#include <sstream>
-
 namespace umbrella {
 namespace objc {
 
+namespace {
+
+/// Current nesting level of Protocol::parse on this thread.
+thread_local uint32_t protocolDepth = 0;
+
+/// Number of adopted protocols dropped at the depth limit on this thread.
+thread_local uint64_t protocolTruncations = 0;
+
+/// Tracks the nesting level of adopted protocols while parsing.
+struct DepthGuard {
+    DepthGuard() { protocolDepth++; }
+    ~DepthGuard() { protocolDepth--; }
+};
+
+} // namespace
+
 std::shared_ptr<Protocol> Protocol::parse(ABIObjectiveC& abi) {
     LIEF::BinaryStream& stream = abi.stream();
+    CACHED(abi.protocolCache, stream.pos())
+    if (protocolDepth > abi.getOptions().maxDepth) {
+        // adopted protocols are nested too deep, most likely crafted data
+        protocolTruncations++;
+        return nullptr;
+    }
+
+    DepthGuard guard;
     PEEK(raw, umbrella::objc::protocol_t, stream)
 
     std::shared_ptr<Protocol> protocol = std::make_shared<Protocol>();
     protocol->setAddress(stream.pos());
+    // Register first, protocols may (indirectly) adopt themselves
+    std::shared_ptr<Protocol> interned =
+        abi.intern(protocol->getAddress(), abi.protocolCache, protocol);
+    if (interned != protocol) {
+        // parsed by another thread
+        return interned;
+    }
     protocol->flags = raw->flags;
     STRING_FIXED(protocol->name, raw->name)
 
-    PROTOCOLS(raw->protocols, protocol->protocols)
-    METHODS(raw->required_class_methods, protocol->requiredClassMethods, true)
-    METHODS(raw->optional_class_methods, protocol->optionalClassMethods, true)
-    METHODS(raw->required_instance_methods, protocol->requiredInstanceMethods, false)
-    METHODS(raw->optional_instance_methods, protocol->optionalInstanceMethods, false)
-    PROPERTIES(raw->instance_properties, protocol->instanceProperties)
+    if (abi.getOptions().lazy) {
+        protocol->lazyABI = &abi;
+    } else {
+        const uint64_t truncations = protocolTruncations;
+        protocol->parseMembers(abi, *raw);
+        if (protocolTruncations != truncations) {
+            // Some adopted protocol is missing. Don't keep this one cached, a
+            // visit at a lower depth must parse it completely.
+            abi.forget(protocol);
+        }
+    }
     return protocol;
 }
 
-std::string Protocol::getDeclaration() const {
+void Protocol::parseMembers(ABIObjectiveC& abi, const protocol_t& raw) {
+    LIEF::BinaryStream& stream = abi.stream();
+    PROTOCOLS(raw.protocols, protocols)
+    METHODS(raw.required_class_methods, requiredClassMethods, true)
+    METHODS(raw.optional_class_methods, optionalClassMethods, true)
+    METHODS(raw.required_instance_methods, requiredInstanceMethods, false)
+    METHODS(raw.optional_instance_methods, optionalInstanceMethods, false)
+    PROPERTIES(raw.instance_properties, instanceProperties)
+}
+
+void Protocol::materialize() const {
+    if (!lazyABI) {
+        return;
+    }
+
+    std::call_once(membersOnce, [this]() {
+        lazyABI->withCursor([this]() {
+            if (auto raw = lazyABI->stream().peek<umbrella::objc::protocol_t>(getAddress())) {
+                const_cast<Protocol*>(this)->parseMembers(*lazyABI, *raw);
+            }
+        });
+    });
+}
+
+void Protocol::appendDeclaration(std::string& _Out) const {
     // Protocol dumps will store a detailed overview of stored methods
     // and properties. Especially methods will be devided into class and
     // instance methods, which then will be devided into optional and
     // required methods.
-    std::ostringstream stream;
-    stream << "@protocol " << name << " ";
+    materialize();
+
+    _Out.append("@protocol ").append(name).append(" ");
     if (protocols.size() != 0) {
         // Add protocol conformance
         PROTO_CONFORM_DECL(protocols, "<", ">")
     }
 
     // TODO: parent
-    stream << "\n";
+    _Out.append("\n");
     LIST_DECL(instanceProperties, "\n")
 
     if (optionalClassMethods.size() || optionalInstanceMethods.size()) {
-        stream << "@optional\n";
+        _Out.append("@optional\n");
     }
     LIST_DECL(optionalInstanceMethods, "\n")
     LIST_DECL(optionalClassMethods, "\n")
 
     if (requiredClassMethods.size() || requiredInstanceMethods.size()) {
-        stream << "@required\n";
+        _Out.append("@required\n");
     }
     LIST_DECL(requiredInstanceMethods, "\n")
     LIST_DECL(requiredClassMethods, "\n")
 
-    stream << "@end";
-    return stream.str();
+    _Out.append("@end");
 }
 
 } // namespace objc
@@ -0,0 +1,62 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "umbrella/objc/SelectorIndex.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+std::unique_ptr<SelectorIndex> SelectorIndex::build(const MethodTable& table) {
+  std::unique_ptr<SelectorIndex> index(new SelectorIndex());
+  const std::vector<StringPool::Handle>& selectors = table.getSelectors();
+
+  // Counting sort: the handles are assigned a dense group in order of
+  // their first use, then the rows are placed into their group.
+  std::vector<uint32_t> counts;
+  std::vector<uint32_t> groupOf(selectors.size());
+  for (size_t row = 0; row < selectors.size(); row++) {
+    auto result = index->groups.emplace(selectors[row], static_cast<uint32_t>(counts.size()));
+    if (result.second) {
+      counts.push_back(0);
+    }
+    groupOf[row] = result.first->second;
+    counts[groupOf[row]]++;
+  }
+
+  index->offsets.resize(counts.size() + 1, 0);
+  for (size_t group = 0; group < counts.size(); group++) {
+    index->offsets[group + 1] = index->offsets[group] + counts[group];
+  }
+
+  // rows keep their table order within a group
+  std::vector<uint32_t> next(index->offsets.begin(), index->offsets.end() - 1);
+  index->rows.resize(selectors.size());
+  for (size_t row = 0; row < selectors.size(); row++) {
+    index->rows[next[groupOf[row]]++] = static_cast<uint32_t>(row);
+  }
+  return index;
+}
+
+MethodTable::Range SelectorIndex::find(StringPool::Handle selector) const {
+  auto result = groups.find(selector);
+  if (result == groups.end()) {
+    return {0, 0};
+  }
+  return {offsets[result->second], offsets[result->second + 1]};
+}
+
+} // namespace objc
+} // namespace umbrella
@@ -0,0 +1,167 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+
+#include "umbrella/objc/TypeCache.h"
+#include "umbrella/visibility.h"
+
+namespace umbrella {
+namespace objc {
+
+TypeCache::TypeCache(size_t _Capacity) : capacity(std::max<size_t>(_Capacity, 1)) {}
+
+TypeCache::Entry* TypeCache::find(std::string_view key) {
+  auto result = lookup.find(key);
+  if (result == lookup.end()) {
+    return nullptr;
+  }
+  entries.splice(entries.begin(), entries, result->second);
+  return &*result->second;
+}
+
+TypeCache::Entry& TypeCache::insert(std::string_view key) {
+  if (Entry* entry = find(key)) {
+    // another thread decoded the same key in the meantime
+    return *entry;
+  }
+
+  if (entries.size() >= capacity) {
+    lookup.erase(entries.back().key);
+    entries.pop_back();
+  }
+  entries.emplace_front();
+  entries.front().key = std::string(key);
+  lookup.emplace(entries.front().key, entries.begin());
+  return entries.front();
+}
+
+std::shared_ptr<TypeNode> TypeCache::typedesc(std::string_view _Encoded) {
+  if (_Encoded.empty()) {
+    return nullptr;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry* entry = find(_Encoded);
+    if (entry && entry->hasTree) {
+      hits++;
+      return entry->tree;
+    }
+    misses++;
+  }
+
+  // parsing happens outside of the lock, failures are cached as well
+  std::shared_ptr<TypeNode> tree = objc::parseEncoding(_Encoded).node;
+  std::lock_guard<std::mutex> lock(mutex);
+  Entry& entry = insert(_Encoded);
+  if (!entry.hasTree) {
+    entry.tree = std::move(tree);
+    entry.hasTree = true;
+  }
+  return entry.tree;
+}
+
+std::string TypeCache::decode(std::string_view _Encoded) {
+  std::string result;
+  appendDecoded(_Encoded, result);
+  return result;
+}
+
+void TypeCache::appendDecoded(std::string_view _Encoded, std::string& _Out) {
+  if (_Encoded.empty()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry* entry = find(_Encoded);
+    if (entry && entry->hasDecoded) {
+      hits++;
+      _Out.append(entry->decoded);
+      return;
+    }
+  }
+
+  std::shared_ptr<TypeNode> tree = typedesc(_Encoded);
+  std::string decoded;
+  if (tree) {
+    // malformed encodings are remembered as an empty decode
+    objc::appendDecoded(*tree, decoded);
+  }
+  _Out.append(decoded);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  Entry& entry = insert(_Encoded);
+  entry.tree = std::move(tree);
+  entry.hasTree = true;
+  entry.decoded = std::move(decoded);
+  entry.hasDecoded = true;
+}
+
+std::string TypeCache::signature(std::string_view _Selector, std::string_view _Signature) {
+  std::string result;
+  appendSignature(_Selector, _Signature, result);
+  return result;
+}
+
+void TypeCache::appendSignature(std::string_view _Selector, std::string_view _Signature,
+                                std::string& _Out) {
+  // '\1' never occurs in selectors, thus keys can't collide with encodings
+  std::string key;
+  key.reserve(_Selector.size() + _Signature.size() + 1);
+  key.append(_Selector).append(1, '\1').append(_Signature);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry* entry = find(key)) {
+      hits++;
+      _Out.append(entry->decoded);
+      return;
+    }
+    misses++;
+  }
+
+  std::string decoded;
+  objc::appendSignature(_Selector, _Signature, decoded);
+  _Out.append(decoded);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  Entry& entry = insert(key);
+  entry.decoded = std::move(decoded);
+  entry.hasDecoded = true;
+}
+
+TypeCache::Stats TypeCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return {hits, misses, entries.size(), capacity};
+}
+
+void TypeCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  lookup.clear();
+  entries.clear();
+  hits = 0;
+  misses = 0;
+}
+
+TypeCache& TypeCache::global() {
+  // intentionally leaked, cached trees may be referenced by static objects
+  static TypeCache* cache = new TypeCache();
+  return *cache;
+}
+
+} // namespace objc
+} // namespace umbrella
@@ -18,79 +18,192 @@
 
 #include <algorithm>
 #include <cstring>
-#include <iostream>
-#include <sstream>
-#include <stdexcept>
+
+#include "objc/Declaration.h"
 
 namespace umbrella {
 namespace objc {
 
-using Iterator = std::string::const_iterator;
-
-std::shared_ptr<TypeNode> parseType(Iterator& it, std::shared_ptr<TypeNode> parent,
-                                    const std::string& encoded);
-uint32_t parseNatural(Iterator& it, const std::string& encoded);
-void parseBitfield(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded);
-void parseBlock(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded);
-void parsePointer(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded);
-void parseArray(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded);
-void parseStruct(Iterator& it, std::shared_ptr<TypeNode> node, bool isUnion,
-                 const std::string& encoded);
-void parseObject(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded);
-void parseProperty(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded);
-std::string decodeType(const TypeNode& _Node);
+// Parsing state of a single type encoding. Children of the nodes being
+// parsed are collected on a stack and moved into TypeTree::links once
+// their parent is complete, so that siblings end up next to each other.
+//
+// Every read is checked against the end of the encoding. The first error
+// is recorded and makes all parse functions return immediately, hence
+// malformed input is rejected after at most one pass over it.
+struct TypeParser {
+    TypeTree& tree;
+    std::string_view encoded;
+    size_t pos{0};
+    std::vector<uint32_t> pending;
+    TypeError error{TypeError::NONE};
+    size_t errorOffset{0};
+
+    uint32_t create(uint32_t parent) {
+        TypeNode node;
+        node.parent = parent;
+        node.tree = &tree;
+        tree.nodes.push_back(node);
+        return static_cast<uint32_t>(tree.nodes.size() - 1);
+    }
+
+    void close(uint32_t node, size_t mark) {
+        TypeNode& value = tree.nodes[node];
+        value.firstChild = static_cast<uint32_t>(tree.links.size());
+        value.childCount = static_cast<uint32_t>(pending.size() - mark);
+        tree.links.insert(tree.links.end(), pending.begin() + mark, pending.end());
+        pending.resize(mark);
+    }
+
+    inline bool atEnd() const { return pos >= encoded.size(); }
+    inline bool failed() const { return error != TypeError::NONE; }
+
+    // Returns the current character or '\0' at the end
+    inline char peek() const { return atEnd() ? '\0' : encoded[pos]; }
+
+    bool fail(TypeError kind) {
+        if (!failed()) {
+            error = kind;
+            errorOffset = std::min(pos, encoded.size());
+        }
+        return false;
+    }
+
+    // Consumes the next character, fails at the end of the encoding
+    bool next(char& tok) {
+        if (atEnd()) {
+            return fail(TypeError::UNEXPECTED_END);
+        }
+        tok = encoded[pos++];
+        return true;
+    }
+
+    // Consumes everything up to the delimiter and the delimiter itself
+    bool until(char delimiter, std::string_view& value) {
+        const size_t end = encoded.find(delimiter, pos);
+        if (end == std::string_view::npos) {
+            pos = encoded.size();
+            return fail(TypeError::UNEXPECTED_END);
+        }
+        value = encoded.substr(pos, end - pos);
+        pos = end + 1;
+        return true;
+    }
+};
+
+uint32_t parseType(TypeParser& parser, uint32_t parent, uint32_t depth);
+uint32_t parseNatural(TypeParser& parser);
+void parseBitfield(TypeParser& parser, uint32_t node);
+void parseBlock(TypeParser& parser, uint32_t node, uint32_t depth);
+void parsePointer(TypeParser& parser, uint32_t node, uint32_t depth);
+void parseArray(TypeParser& parser, uint32_t node, uint32_t depth);
+void parseStruct(TypeParser& parser, uint32_t node, bool isUnion, uint32_t depth);
+void parseObject(TypeParser& parser, uint32_t node, uint32_t depth);
+void parseProperty(TypeParser& parser, uint32_t node, uint32_t depth);
+void decodeType(const TypeNode& _Node, std::string& _Out);
+
+std::vector<std::string_view> TypeNode::getAttributes() const {
+    std::vector<std::string_view> names;
+    for (char tok : qualifiers) {
+        names.push_back(typeCode(tok).name);
+    }
+    return names;
+}
+
 // public:
-std::shared_ptr<TypeNode> typedesc(const std::string& _Encoded) {
+TypeResult parseEncoding(std::string_view _Encoded) {
+    TypeResult result;
     if (_Encoded.empty()) {
-        return nullptr;
+        result.error = TypeError::UNEXPECTED_END;
+        return result;
     }
 
-    Iterator it = std::begin(_Encoded);
-    const size_t _Length = _Encoded.size();
-    std::shared_ptr<TypeNode> type = std::make_shared<TypeNode>();
-    while (it != std::end(_Encoded)) {
-        std::shared_ptr<TypeNode> child = parseType(it, type, _Encoded);
-        type->children.push_back(std::move(child));
+    std::shared_ptr<TypeTree> tree = std::make_shared<TypeTree>();
+    tree->encoded = std::string(_Encoded);
+    TypeParser parser{*tree, tree->encoded};
+
+    const uint32_t root = parser.create(TypeNode::NONE);
+    while (!parser.atEnd() && !parser.failed()) {
+        parser.pending.push_back(parseType(parser, root, 0));
     }
-    return type;
+    if (parser.failed()) {
+        result.error = parser.error;
+        result.offset = parser.errorOffset;
+        return result;
+    }
+
+    parser.close(root, 0);
+    // the root shares ownership of the whole tree
+    result.node = std::shared_ptr<TypeNode>(tree, &tree->nodes[root]);
+    return result;
 }
 
-std::string decode(const TypeNode& _Node) {
+std::shared_ptr<TypeNode> typedesc(const std::string& _Encoded) {
+    return parseEncoding(_Encoded).node;
+}
+
+const char* describe(TypeError _Error) {
+    switch (_Error) {
+    case TypeError::NONE:
+        return "no error";
+    case TypeError::UNEXPECTED_END:
+        return "unexpected end of type encoding";
+    case TypeError::TOO_DEEP:
+        return "type encoding is nested too deeply";
+    case TypeError::NUMBER_TOO_LARGE:
+        return "number in type encoding is too large";
+    }
+    return "unknown error";
+}
+
+void appendDecoded(const TypeNode& _Node, std::string& _Out) {
     if (_Node.type != 0) {
-        return decodeType(_Node);
+        decodeType(_Node, _Out);
+        return;
     }
 
-    std::ostringstream stream;
-    size_t count = _Node.children.size();
+    size_t count = _Node.getChildCount();
     for (size_t i = 0; i < count; i++) {
-        stream << decodeType(*_Node.children[i]);
+        decodeType(_Node[i], _Out);
         if (i != (count - 1)) {
-            stream << " ";
+            _Out.push_back(' ');
         }
     }
-    return stream.str();
 }
 
-std::string signature(const std::string& _Selector, const std::string& _Signature) {
-    std::ostringstream stream;
-    std::shared_ptr<TypeNode> node = typedesc(_Signature);
-    const TypeNode& returnType = *node->children[0];
-    const size_t count = node->children.size();
+std::string decode(const TypeNode& _Node) {
+    std::string result;
+    appendDecoded(_Node, result);
+    return result;
+}
+
+void appendSignature(std::string_view _Selector, std::string_view _Signature, std::string& _Out) {
+    std::shared_ptr<TypeNode> node = parseEncoding(_Signature).node;
+    if (!node || node->getChildCount() == 0) {
+        // malformed signatures keep at least the selector
+        _Out.append("(?)").append(_Selector);
+        return;
+    }
 
-    stream << '(' << decode(returnType) << ")";
+    const TypeNode& returnType = (*node)[0];
+    const size_t count = node->getChildCount();
+
+    _Out.push_back('(');
+    appendDecoded(returnType, _Out);
+    _Out.push_back(')');
     // 0 => rtype
     // 1 => sel
     // 2 => id
     if (count <= 3) {
         // no arguments
-        stream << _Selector;
-        return stream.str();
+        _Out.append(_Selector);
+        return;
     }
 
     size_t start = 0;
     size_t pos = 0;
     size_t index = 3;
-    std::string token;
+    std::string_view token;
 
     // This way we sanitize labels and ignore anonymous parameters
     do {
@@ -100,458 +213,462 @@ std::string signature(const std::string& _Selector, const std::string& _Signatur
         pos = _Selector.find(':', start);
         token = _Selector.substr(start, pos - start);
         if (!token.empty()) {
-            const TypeNode& child = *node->children[index];
-            stream << token << ":(" << decode(child) << ")";
+            _Out.append(token).append(":(");
+            appendDecoded((*node)[index], _Out);
+            _Out.push_back(')');
 
             if (index < (count - 1)) {
-                stream << " ";
+                _Out.push_back(' ');
             }
         }
         start = pos + 1;
         index++;
     } while (pos != std::string::npos);
+}
 
-    return stream.str();
+std::string signature(const std::string& _Selector, const std::string& _Signature) {
+    std::string result;
+    appendSignature(_Selector, _Signature, result);
+    return result;
 }
 
 // private:
-std::shared_ptr<TypeNode> parseType(Iterator& it, std::shared_ptr<TypeNode> parent,
-                                    const std::string& encoded) {
-    std::shared_ptr<TypeNode> node = std::make_shared<TypeNode>();
-    node->parent = std::move(parent);
-
-    char tok = *it++;
-    auto search = OBJC_METHOD_TYPES.find(tok);
-    while (search != std::end(OBJC_METHOD_TYPES)) {
-        MethodType methodType = search->second;
-        switch (methodType) {
-#define METHOD_TYPE(id, name, value)                                                               \
-    case MethodType::value: {                                                                      \
-        std::string _name(name);                                                                   \
-        node->attributes.push_back(std::move(_name));                                              \
-        break;                                                                                     \
+uint32_t parseType(TypeParser& parser, uint32_t parent, uint32_t depth) {
+    if (depth >= TYPE_MAX_DEPTH) {
+        parser.fail(TypeError::TOO_DEEP);
+        return parent;
     }
 
-#include "umbrella/objc/TypeEncoding.def"
-#undef METHOD_TYPE
+    if (parser.peek() == '"') {
+        // Special case: struct member definition starting with a name
+        parser.pos++;
+        std::string_view memberName;
+        if (!parser.until('"', memberName)) {
+            return parent;
         }
 
-        tok = *it++;
-        search = OBJC_METHOD_TYPES.find(tok);
+        // REVISIT: This actually does not parse types in the way we
+        // want them to be parsed. The returned TypeNode should be
+        // stored as a child node with Type::STRUCT_MEMBER as its type.
+        uint32_t node = parseType(parser, parent, depth + 1);
+        if (!parser.failed()) {
+            parser.tree.nodes[node].name = memberName;
+        }
+        return node;
     }
 
-    auto simpleTypeResult = OBJC_NODE_TYPES.find(tok);
-    if (simpleTypeResult != std::end(OBJC_NODE_TYPES)) {
-        Type type = simpleTypeResult->second;
-        switch (type) {
-#define OBJC_TYPE(id, name_, alignment_, value)                                                    \
-    case Type::value: {                                                                            \
-        node->name = std::move(std::string(name_));                                                \
-        node->type = (uint32_t)Type::value;                                                        \
-        node->alignment = alignment_;                                                              \
-        node->size = alignment_;                                                                   \
-        break;                                                                                     \
-    }
+    const uint32_t node = parser.create(parent);
+    const size_t mark = parser.pending.size();
 
-#include "umbrella/objc/TypeEncoding.def"
-#undef OBJC_TYPE
+    const size_t qualifiers = parser.pos;
+    char tok;
+    do {
+        if (!parser.next(tok)) {
+            return node;
         }
+    } while (typeCode(tok).isQualifier());
+    parser.tree.nodes[node].qualifiers =
+        parser.encoded.substr(qualifiers, parser.pos - 1 - qualifiers);
+
+    const TypeCode& code = typeCode(tok);
+    if (code.isSimpleType()) {
+        TypeNode& value = parser.tree.nodes[node];
+        value.name = code.name;
+        value.type = code.type;
+        value.alignment = code.alignment;
+        value.size = code.alignment;
     } else {
         switch (tok) {
         case '^':
-            parsePointer(it, node, encoded);
+            parsePointer(parser, node, depth);
             break;
 
         case '[':
-            parseArray(it, node, encoded);
+            parseArray(parser, node, depth);
             break;
 
         case '{':
-            parseStruct(it, node, false, encoded);
+            parseStruct(parser, node, false, depth);
             break;
 
         case '(':
-            parseStruct(it, node, true, encoded);
+            parseStruct(parser, node, true, depth);
             break;
 
         case '@':
-            parseObject(it, node, encoded);
+            parseObject(parser, node, depth);
             break;
 
         case 'b':
-            parseBitfield(it, node, encoded);
-            break;
-
-        case '"': {
-            // Special case: struct member definition starting with a name
-            std::string memberName;
-            while (*it != '"' && it != std::end(encoded)) {
-                memberName.append({*it++});
-            }
-            it++;  // skip trailing "
-
-            // REVISIT: This actually does not parse types in the way we
-            // want them to be parsed. The returned TypeNode should be
-            // stored as a child node with Type::STRUCT_MEMBER as its type.
-            node = parseType(it, node, encoded);
-            node->name = std::move(memberName);
+            parseBitfield(parser, node);
             break;
-        }
 
         case 'T':
             // Special case: the whole string defines property attributes
-            parseProperty(it, node, encoded);
+            parseProperty(parser, node, depth);
             break;
         }
     }
 
-    node->stack_size = parseNatural(it, encoded);
+    if (parser.failed()) {
+        return node;
+    }
+    parser.close(node, mark);
+    parser.tree.nodes[node].stack_size = parseNatural(parser);
     return node;
 }
 
-void parseBitfield(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded) {
-    uint32_t count = parseNatural(it, encoded);
-    node->size = count;
-    node->alignment = count;
-    node->type = (uint32_t)Type::BIT_FIELD;
+void parseBitfield(TypeParser& parser, uint32_t node) {
+    uint32_t count = parseNatural(parser);
+    TypeNode& value = parser.tree.nodes[node];
+    value.size = count;
+    value.alignment = count;
+    value.type = (uint32_t)Type::BIT_FIELD;
 }
 
-void parseBlock(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded) {
-    if (*it == '?') {
-        ++it;  // Special case: ^? --> void*
-        node->type = (uint32_t)Type::PVOID;
-        return;
-    }
-
-    if (*it == '<')
-        // Skip block start
-        ++it;
+void parseBlock(TypeParser& parser, uint32_t node, uint32_t depth) {
+    // Blocks are represented as "@?<rtype@?args...>", the cursor is at '<'
+    parser.pos++;
 
-    std::shared_ptr<TypeNode> return_type = parseType(it, node, encoded);
-    node->children.push_back(std::move(return_type));
+    // return type and block self
+    parser.pending.push_back(parseType(parser, node, depth + 1));
+    parser.pending.push_back(parseType(parser, node, depth + 1));
 
-    std::shared_ptr<TypeNode> block_self = parseType(it, node, encoded);
-    node->children.push_back(std::move(block_self));
-
-    while (*it != '>') {
-        std::shared_ptr<TypeNode> child = parseType(it, node, encoded);
-        node->size += child->size;
-        node->children.push_back(std::move(child));
+    while (!parser.failed() && parser.peek() != '>') {
+        uint32_t child = parseType(parser, node, depth + 1);
+        if (parser.failed()) {
+            return;
+        }
+        parser.tree.nodes[node].size += parser.tree.nodes[child].size;
+        parser.pending.push_back(child);
     }
 
-    if (*it == '>') {
-        ++it;  // skip '>' at the end
+    char tok;
+    if (!parser.next(tok)) {
+        return;  // missing '>' at the end
     }
-    node->type = (uint32_t)Type::BLOCK;
-    node->alignment = 8;
+    TypeNode& value = parser.tree.nodes[node];
+    value.type = (uint32_t)Type::BLOCK;
+    value.alignment = 8;
 }
 
-void parsePointer(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded) {
-    std::shared_ptr<TypeNode> child = parseType(it, node, encoded);
-    node->children.push_back(std::move(child));
-    node->size = 8;
-    node->alignment = 8;
-    node->type = (uint32_t)Type::POINTER;
+void parsePointer(TypeParser& parser, uint32_t node, uint32_t depth) {
+    parser.pending.push_back(parseType(parser, node, depth + 1));
+    TypeNode& value = parser.tree.nodes[node];
+    value.size = 8;
+    value.alignment = 8;
+    value.type = (uint32_t)Type::POINTER;
 }
 
-void parseArray(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded) {
-    uint32_t count = parseNatural(it, encoded);
-    std::shared_ptr<TypeNode> child = parseType(it, node, encoded);
+void parseArray(TypeParser& parser, uint32_t node, uint32_t depth) {
+    uint32_t count = parseNatural(parser);
+    if (parser.failed()) {
+        return;
+    }
+    uint32_t child = parseType(parser, node, depth + 1);
+    if (parser.failed()) {
+        return;
+    }
 
-    node->type = (uint32_t)Type::ARRAY;
-    node->size = count;
-    node->dim = count;
-    node->alignment = child->alignment;
-    node->children.push_back(std::move(child));
+    TypeNode& value = parser.tree.nodes[node];
+    value.type = (uint32_t)Type::ARRAY;
+    value.size = count;
+    value.dim = count;
+    value.alignment = parser.tree.nodes[child].alignment;
+    parser.pending.push_back(child);
 
-    if (*(it) == ']') {
+    if (parser.atEnd()) {
+        parser.fail(TypeError::UNEXPECTED_END);
+    } else if (parser.peek() == ']') {
         // Make sure we skip the closing bracket
-        ++it;
+        parser.pos++;
     }
 }
 
-uint32_t parseNatural(Iterator& it, const std::string& encoded) {
-    if (it == std::end(encoded)) {
-        return 0;
-    }
-
+uint32_t parseNatural(TypeParser& parser) {
     uint32_t value = 0;
-    while ('0' <= *it && '9' >= *it) {
-        char tok = *it++;
-        int digit = tok - '0';
-        value *= 10;
-        value += digit;
+    while ('0' <= parser.peek() && '9' >= parser.peek()) {
+        const uint32_t digit = static_cast<uint32_t>(parser.peek() - '0');
+        if (value > (UINT32_MAX - digit) / 10) {
+            parser.fail(TypeError::NUMBER_TOO_LARGE);
+            return 0;
+        }
+        parser.pos++;
+        value = value * 10 + digit;
     }
     return value;
 }
 
-void parseObject(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded) {
-    if (*it == '?') {
-        it++;  // skip blocks
-        if (*it == '<') {
+void parseObject(TypeParser& parser, uint32_t node, uint32_t depth) {
+    if (parser.peek() == '?') {
+        parser.pos++;  // skip blocks
+        if (parser.peek() == '<') {
             // actual block definition, parse that and return
-            parseBlock(it, node, encoded);
+            parseBlock(parser, node, depth);
             return;
         }
     }
 
-    if (*it == '"') {
-        ++it;  // skip '"'
-        std::string name;
+    TypeNode& value = parser.tree.nodes[node];
+    if (parser.peek() == '"') {
+        parser.pos++;  // skip '"'
 
         // parse additional name
-        while (*it != '"' && it != std::end(encoded)) {
-            name.append({*it++});
+        std::string_view name;
+        if (!parser.until('"', name)) {
+            return;
         }
-        ++it;  // skip '"' at the end
-        node->name = std::move(name);
+        value.name = name;
     } else {
-        node->name = "id";
+        value.name = "id";
     }
 
-    node->type = (uint32_t)Type::OBJECT;
-    node->size = 8;
-    node->alignment = 8;
+    value.type = (uint32_t)Type::OBJECT;
+    value.size = 8;
+    value.alignment = 8;
 }
 
-void parseStruct(Iterator& it, std::shared_ptr<TypeNode> node, bool isUnion,
-                 const std::string& encoded) {
+void parseStruct(TypeParser& parser, uint32_t node, bool isUnion, uint32_t depth) {
     // Structs are represented as "{name=??}", the cursor has moved pass '{'
     // when this function is called.
-    std::string name;
-    node->type = (uint32_t)(isUnion ? Type::UNION : Type::STRUCT);
+    parser.tree.nodes[node].type = (uint32_t)(isUnion ? Type::UNION : Type::STRUCT);
 
-    char close_tok = isUnion ? ')' : '}';
-    while (it != std::end(encoded)) {
-        char tok = *it++;
-        if (tok == '=') {
-            break;
+    const char close_tok = isUnion ? ')' : '}';
+    const size_t begin = parser.pos;
+    char tok;
+    do {
+        if (!parser.next(tok)) {
+            return;  // missing '=' or closing token
         }
+    } while (tok != '=' && tok != close_tok);
 
-        if (tok == close_tok) {
-            node->name = std::move(name);
-            return;
-        }
-        name.append({tok});
+    parser.tree.nodes[node].name = parser.encoded.substr(begin, parser.pos - 1 - begin);
+    if (tok == close_tok) {
+        return;
     }
 
-    node->name = std::move(name);
-    while (it != std::end(encoded)) {
-        char tok = *it;
-        if (tok == close_tok) {
-            it++;  // skip close token
-            break;
+    while (parser.peek() != close_tok) {
+        if (parser.atEnd()) {
+            parser.fail(TypeError::UNEXPECTED_END);
+            return;
         }
 
-        std::shared_ptr<TypeNode> child = parseType(it, node, encoded);
-        node->alignment = std::max(child->alignment, node->alignment);
+        uint32_t child = parseType(parser, node, depth + 1);
+        if (parser.failed()) {
+            return;
+        }
+        const TypeNode& member = parser.tree.nodes[child];
+        TypeNode& value = parser.tree.nodes[node];
+        value.alignment = std::max(member.alignment, value.alignment);
         if (isUnion) {
-            node->size += child->size;
+            value.size += member.size;
         } else {
-            node->size = std::max(child->size, node->size);
+            value.size = std::max(member.size, value.size);
         }
-        node->children.push_back(std::move(child));
+        parser.pending.push_back(child);
     }
+    parser.pos++;  // skip close token
 }
 
-void parseProperty(Iterator& it, std::shared_ptr<TypeNode> node, const std::string& encoded) {
-    size_t start = std::distance(std::begin(encoded), it);
+void parseProperty(TypeParser& parser, uint32_t node, uint32_t depth) {
+    std::string_view encoded = parser.encoded;
+    size_t start = parser.pos;
     size_t pos = start;
     size_t index = 0;
-    std::string token;
+    std::string_view token;
 
-    size_t debug_index = start;
-
-    node->type = (uint32_t)Type::ATTRIBUTES;
+    parser.tree.nodes[node].type = (uint32_t)Type::ATTRIBUTES;
     do {
         pos = encoded.find(',', start);
         token = encoded.substr(start, pos - start);
 
         // Child 0 is always the typedesc
         if (index == 0) {
-            std::shared_ptr<TypeNode> child = parseType(it, node, encoded);
-            node->children.push_back(std::move(child));
+            parser.pending.push_back(parseType(parser, node, depth + 1));
+            if (parser.failed()) {
+                return;
+            }
         } else {
-            std::shared_ptr<TypeNode> attrNode = std::make_shared<TypeNode>();
-            switch (token[0]) {
+            const uint32_t attrNode = parser.create(node);
+            TypeNode& attr = parser.tree.nodes[attrNode];
+            switch (token.empty() ? '\0' : token[0]) {
 #define ATTR_TYPE(id, name_, value)                                                                \
     case id:                                                                                       \
-        attrNode->name = std::string(name_);                                                       \
-        attrNode->type = (uint32_t)AttributeType::value;                                           \
+        attr.name = name_;                                                                         \
+        attr.type = (uint32_t)AttributeType::value;                                                \
         break;
 #include "umbrella/objc/TypeEncoding.def"
 #undef ATTR_TYPE
 
             case 'G':  // Getter
-                attrNode->type = (uint32_t)AttributeType::GETTER;
-                attrNode->name = token.substr(1);
+                attr.type = (uint32_t)AttributeType::GETTER;
+                attr.name = token.substr(1);
                 break;
 
             case 'S':  // Setter
-                attrNode->type = (uint32_t)AttributeType::SETTER;
-                attrNode->name = token.substr(1);
+                attr.type = (uint32_t)AttributeType::SETTER;
+                attr.name = token.substr(1);
                 break;
 
             default:
                 // the last child is the name of the backing instance variable
-                node->name = std::move(token);
+                parser.tree.nodes[node].name = token;
                 break;
             }
-
-            node->children.push_back(std::move(attrNode));
+            parser.pending.push_back(attrNode);
         }
 
         index++;
         start = pos + 1;  // plus one due to delimiter
-    } while (pos != std::string::npos);
+    } while (pos != std::string_view::npos);
 
     // We assume that only one property encoding per type encoding
     // is possible.
-    it = std::end(encoded);
+    parser.pos = encoded.size();
 }
 
-std::string decodeType(const TypeNode& _Node) {
-    std::ostringstream stream;
-    if (!_Node.attributes.empty()) {
-        // append attributes first (if present). The whitespace at the end
-        // can be aded safely as a node can not be of an unregistered type
-        // but stores attributes.
-        for (const auto& attribute : _Node.attributes) {
-            stream << attribute << " ";
-        }
+void decodeType(const TypeNode& _Node, std::string& _Out) {
+    // append attributes first (if present). The whitespace at the end
+    // can be aded safely as a node can not be of an unregistered type
+    // but stores attributes.
+    for (char tok : _Node.qualifiers) {
+        _Out.append(typeCode(tok).name).push_back(' ');
     }
 
     // Search for any primitive types
-    auto result = OBJC_NODE_TYPE_NAMES.find(_Node.type);
-    if (result != std::end(OBJC_NODE_TYPE_NAMES) || _Node.type == (uint32_t)Type::OBJECT) {
+    if (isSimpleType(_Node.type) || _Node.type == (uint32_t)Type::OBJECT) {
         // name of simple types are set by default
-        stream << _Node.name;
-    } else {
-        const size_t count = _Node.children.size();
+        _Out.append(_Node.name);
+        return;
+    }
+
+    const size_t count = _Node.getChildCount();
+    switch (_Node.type) {
+    case (uint32_t)Type::BIT_FIELD: {
+        _Out.append("BitField<");
+        appendNumber(_Out, _Node.size);
+        _Out.push_back('>');
+        break;
+    }
 
-        switch (_Node.type) {
-        case (uint32_t)Type::BIT_FIELD: {
-            stream << "BitField<" << _Node.size << ">";
+    case (uint32_t)Type::POINTER: {
+        if (count != 1) {
+            // not created by the parser, the target is unknown
+            _Out.append("? *");
             break;
         }
 
-        case (uint32_t)Type::POINTER: {
-            if (_Node.children.size() != 1) {
-                // This error will be converted to 'ValueError' on Python side.
-                throw std::range_error("Invalid children count on POINTER node!");
-            }
+        const size_t begin = _Out.size();
+        appendDecoded(_Node[0], _Out);
+        _Out.append(_Out.size() > begin && _Out.back() == '*' ? "*" : " *");
+        break;
+    }
 
-            std::string ptrChild = decode(*_Node.children[0]);
-            stream << ptrChild << (ptrChild[ptrChild.size() - 1] == '*' ? "*" : " *");
-            break;
+    case (uint32_t)Type::ARRAY: {
+        appendDecoded(_Node[0], _Out);
+        if (_Node.dim != 0) {
+            // FIXME: this results in swapped dimensions in case of
+            // multidimensional arrays
+            _Out.push_back('[');
+            appendNumber(_Out, _Node.dim);
+            _Out.push_back(']');
+        } else {
+            _Out.append("[]");
         }
+        break;
+    }
 
-        case (uint32_t)Type::ARRAY: {
-            std::string arrChild = decode(*_Node.children[0]);
-            if (_Node.dim != 0) {
-                // FIXME: this results in swapped dimensions in case of
-                // multidimensional arrays
-                stream << arrChild << "[" << _Node.dim << "]";
-            } else {
-                stream << arrChild << "[]";
-            }
-            break;
-        }
+    case (uint32_t)Type::STRUCT: {
+        // TODO: maybe add option to expand structs and unions
+        _Out.append("struct ").append(_Node.name);
+        break;
+    }
 
-        case (uint32_t)Type::STRUCT: {
-            // TODO: maybe add option to expand structs and unions
-            stream << "struct " << _Node.name;
-            break;
-        }
+    case (uint32_t)Type::UNION: {
+        // TODO: maybe add option to expand structs and unions
+        _Out.append("union ").append(_Node.name);
+        break;
+    }
 
-        case (uint32_t)Type::UNION: {
-            // TODO: maybe add option to expand structs and unions
-            stream << "union " << _Node.name;
-            break;
-        }
+    case (uint32_t)Type::PVOID: {
+        _Out.append("void *");
+        break;
+    }
 
-        case (uint32_t)Type::PVOID: {
-            stream << "void *";
-            break;
+    case (uint32_t)Type::BLOCK: {
+        //  void (^id)(NSError, ...)
+        //    ^            ^     ^
+        // This implementation ignores the 'Self' argument of each block.
+        appendDecoded(_Node[0], _Out);
+        _Out.append(" (^_)(");
+        for (size_t i = 2; i < count; i++) {
+            appendDecoded(_Node[i], _Out);
+            if (i != (count - 1)) {
+                _Out.append(", ");
+            }
         }
+        _Out.push_back(')');
+        break;
+    }
 
-        case (uint32_t)Type::BLOCK: {
-            //  void (^id)(NSError, ...)
-            //    ^            ^     ^
-            // This implementation ignores the 'Self' argument of each block.
-            const TypeNode& returnType = *_Node.children[0];
-            stream << decode(returnType) << " ";
-
-            std::ostringstream attrStream;
-            if (count >= 2) {  // additional check to prevent errors
-                for (size_t i = 2; i < count; i++) {
-                    attrStream << decode(*_Node.children[i]);
-                    if (i != (count - 1)) {
-                        attrStream << ", ";
-                    }
-                }
+    case (uint32_t)Type::ATTRIBUTES: {
+        // First child is type, @dynamic is placed in front of the whole
+        // declaration
+        for (size_t i = 1; i < count; i++) {
+            if (_Node[i].getAttributeType() == AttributeType::DYNAMIC) {
+                _Out.append("@dynamic ");
             }
-            stream << "(^_)(" << attrStream.str() << ")";
-            break;
         }
 
-        case (uint32_t)Type::ATTRIBUTES: {
-            // First child is type
-            const TypeNode& typeSpec = *_Node.children[0];
-            std::ostringstream attributes;
-
-            for (size_t i = 1; i < count; i++) {
-                const TypeNode& child = *_Node.children[i];
-                switch (child.getAttributeType()) {
-                case AttributeType::GETTER: {
-                    attributes << "getter=" << child.name;
-                    break;
-                }
-                case AttributeType::SETTER: {
-                    attributes << "setter=" << child.name;
-                    break;
-                }
-                case AttributeType::DYNAMIC: {
-                    stream << "@dynamic ";
-                    break;
-                }
-                default: {
-                    if (!child.name.empty()) {
-                        attributes << child.name;
-                    }
-                    break;
-                }
-                }  // end switch
-                // FIXME: this results sometimes in @property (..., ) foo
-                if (i < (count - 1)) {
-                    attributes << ", ";
-                }
+        _Out.append("@property");
+        if (count > 1) {
+            _Out.append(" (");
+        }
+        for (size_t i = 1; i < count; i++) {
+            const TypeNode& child = _Node[i];
+            switch (child.getAttributeType()) {
+            case AttributeType::GETTER: {
+                _Out.append("getter=").append(child.name);
+                break;
             }
-
-            stream << "@property";
-            if (count > 1) {
-                stream << " (" << attributes.str() << ")";
+            case AttributeType::SETTER: {
+                _Out.append("setter=").append(child.name);
+                break;
             }
-
-            stream << " " << decode(typeSpec);
-            if (!_Node.name.empty()) {
-                stream << " ";
-                if (_Node.name.size() > 2 && _Node.name[0] == 'V' && _Node.name[1] == '_') {
-                    stream << _Node.name.substr(2);
-                } else {
-                    stream << _Node.name;
-                }
+            case AttributeType::DYNAMIC: {
+                break;
             }
-            break;
+            default: {
+                _Out.append(child.name);
+                break;
+            }
+            }  // end switch
+            // FIXME: this results sometimes in @property (..., ) foo
+            if (i < (count - 1)) {
+                _Out.append(", ");
+            }
+        }
+        if (count > 1) {
+            _Out.push_back(')');
         }
 
-        default:
-            stream << "?";
-            break;
+        _Out.push_back(' ');
+        appendDecoded(_Node[0], _Out);
+        if (!_Node.name.empty()) {
+            _Out.push_back(' ');
+            if (_Node.name.size() > 2 && _Node.name[0] == 'V' && _Node.name[1] == '_') {
+                _Out.append(_Node.name.substr(2));
+            } else {
+                _Out.append(_Node.name);
+            }
         }
+        break;
     }
 
-    return stream.str();
+    default:
+        _Out.push_back('?');
+        break;
+    }
 }
 
 } // namespace objc
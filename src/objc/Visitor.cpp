@@ -0,0 +1,324 @@
+/**
+ * Copyright 2023 MatrixEditor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstddef>
+
+#include <LIEF/BinaryStream/BinaryStream.hpp>
+
+#include "umbrella/objc/ABI.h"
+#include "umbrella/objc/Types.h"
+#include "umbrella/objc/Visitor.h"
+#include "umbrella/visibility.h"
+
+#include "objc/Parsing.h"  // private include
+
+namespace umbrella {
+namespace objc {
+
+namespace {
+
+/// Walks the raw metadata and fills the (reused) records of a visitor.
+class Walker {
+private:
+  ABIObjectiveC& abi;
+  LIEF::BinaryStream& stream;
+  Visitor& visitor;
+
+  ClassRecord classRecord;
+  ProtocolRecord protocolRecord;
+  CategoryRecord categoryRecord;
+  MethodRecord methodRecord;
+  IVarRecord ivarRecord;
+  PropertyRecord propertyRecord;
+  ConformanceRecord conformanceRecord;
+
+public:
+  Walker(ABIObjectiveC& _ABI, Visitor& _Visitor)
+    : abi(_ABI), stream(_ABI.stream()), visitor(_Visitor) {}
+
+  void classes();
+  void categories();
+  void protocols();
+
+private:
+  void string(std::string& attr, uintptr_t address);
+  void importName(std::string& attr, uintptr_t location, uintptr_t ptr);
+  uintptr_t fixed(uintptr_t ptr) const { return ptr ? abi.fixPointer(ptr) : 0; }
+  uintptr_t fixedAt(uintptr_t location, uintptr_t ptr) const {
+    return ptr ? abi.fixPointerAt(location, ptr) : 0;
+  }
+  uintptr_t classData(const umbrella::objc::class_t& raw) const {
+    return fixed(raw.bits.value()) & umbrella::objc::class_data_bits_t::MASK;
+  }
+
+  void methods(uintptr_t owner, uintptr_t listAddress, bool isClass, bool isOptional = false);
+  void properties(uintptr_t owner, uintptr_t listAddress, bool isClass);
+  void conformances(uintptr_t owner, uintptr_t listAddress);
+  void ivars(uintptr_t owner, uintptr_t listAddress);
+};
+
+void Walker::importName(std::string& attr, uintptr_t location, uintptr_t ptr) {
+  std::string_view symbol = abi.getImportNameAt(location);
+  if (symbol.empty()) {
+    symbol = abi.getImportName(ptr);
+  }
+  attr.assign(symbol.data(), symbol.size());
+}
+
+void Walker::string(std::string& attr, uintptr_t address) {
+  attr.clear();
+  if (auto result = stream.peek_string_at(address)) {
+    attr = std::move(*result);
+  }
+}
+
+void Walker::classes() {
+  for (uintptr_t location : __objc_list_entries(abi, "__objc_classlist")) {
+    const auto raw = stream.peek<umbrella::objc::class_t>(location);
+    if (!raw || !classData(*raw)) {
+      continue;
+    }
+
+    const auto raw_data = stream.peek<umbrella::objc::class_ro_t>(classData(*raw));
+    if (!raw_data) {
+      continue;
+    }
+
+    classRecord.address = location;
+    // same resolution as Class::parse, bound slots take precedence
+    const uintptr_t superLocation = location + sizeof(umbrella::objc::object_t);
+    classRecord.superClass = fixedAt(superLocation, raw->super_class);
+    importName(classRecord.importedSuperClass, superLocation, raw->super_class);
+    classRecord.metaClass = fixedAt(location, raw->isa);
+    classRecord.flags = raw_data->flags;
+    string(classRecord.name, abi.fixPointer(raw_data->name));
+    if (!visitor.onClass(classRecord)) {
+      continue;
+    }
+
+    conformances(location, raw_data->base_protocols);
+    ivars(location, raw_data->ivars);
+    properties(location, raw_data->base_properties, false);
+    methods(location, raw_data->base_methods, false);
+
+    // Class methods and properties are stored in the metaclass, but will
+    // be reported for the class itself.
+    if (!classRecord.metaClass) {
+      continue;
+    }
+    if (const auto meta = stream.peek<umbrella::objc::class_t>(classRecord.metaClass)) {
+      if (const uintptr_t metaData = classData(*meta)) {
+        if (const auto meta_data = stream.peek<umbrella::objc::class_ro_t>(metaData)) {
+          properties(location, meta_data->base_properties, true);
+          methods(location, meta_data->base_methods, true);
+        }
+      }
+    }
+  }
+}
+
+void Walker::categories() {
+  for (uintptr_t location : __objc_list_entries(abi, "__objc_catlist")) {
+    const auto raw = stream.peek<umbrella::objc::category_t>(location);
+    if (!raw) {
+      continue;
+    }
+
+    categoryRecord.address = location;
+    const uintptr_t baseLocation = location + offsetof(umbrella::objc::category_t, base_class);
+    categoryRecord.baseClass = fixedAt(baseLocation, raw->base_class);
+    importName(categoryRecord.importedBaseClass, baseLocation, raw->base_class);
+    string(categoryRecord.name, abi.fixPointer(raw->name));
+    if (!visitor.onCategory(categoryRecord)) {
+      continue;
+    }
+
+    conformances(location, raw->base_protocols);
+    properties(location, raw->instance_properties, false);
+    methods(location, raw->instance_methods, false);
+    methods(location, raw->class_methods, true);
+  }
+}
+
+void Walker::protocols() {
+  for (uintptr_t location : __objc_list_entries(abi, "__objc_protolist")) {
+    const auto raw = stream.peek<umbrella::objc::protocol_t>(location);
+    if (!raw) {
+      continue;
+    }
+
+    protocolRecord.address = location;
+    protocolRecord.flags = raw->flags;
+    string(protocolRecord.name, abi.fixPointer(raw->name));
+    if (!visitor.onProtocol(protocolRecord)) {
+      continue;
+    }
+
+    conformances(location, raw->protocols);
+    properties(location, raw->instance_properties, false);
+    methods(location, raw->required_instance_methods, false);
+    methods(location, raw->required_class_methods, true);
+    methods(location, raw->optional_instance_methods, false, true);
+    methods(location, raw->optional_class_methods, true, true);
+  }
+}
+
+void Walker::methods(uintptr_t owner, uintptr_t listAddress, bool isClass, bool isOptional) {
+  if (!listAddress) {
+    return;
+  }
+
+  LIST(listAddress, umbrella::objc::method_list_t) {
+    const bool isSmall = list->flags() & method_list_t::IS_SMALL;
+    const size_t size = isSmall ? sizeof(small_method_t) : sizeof(big_method_t);
+    const size_t baseAddress = stream.pos();
+
+    methodRecord.owner = owner;
+    methodRecord.classMethod = isClass;
+    methodRecord.optional = isOptional;
+    for (size_t i = 0; i < list->count; i++) {
+      const uintptr_t address = baseAddress + i * size;
+      methodRecord.address = address;
+      methodRecord.impl = 0;
+      if (isSmall) {
+        // All fields store offsets relative to their own location
+        const auto raw = stream.peek<umbrella::objc::small_method_t>(address);
+        if (!raw) {
+          break;
+        }
+
+        const uintptr_t selRef = address + (intptr_t)raw->name;
+        methodRecord.name.clear();
+        if (auto result = stream.peek<uintptr_t>(selRef)) {
+          string(methodRecord.name, fixedAt(selRef, *result));
+        }
+        string(methodRecord.signature,
+               address + offsetof(small_method_t, signature) + (intptr_t)raw->signature);
+        if (raw->impl) {
+          methodRecord.impl = address + offsetof(small_method_t, impl) + (intptr_t)raw->impl;
+        }
+      } else {
+        const auto raw = stream.peek<umbrella::objc::big_method_t>(address);
+        if (!raw) {
+          break;
+        }
+
+        string(methodRecord.name, abi.fixPointer(raw->name));
+        string(methodRecord.signature, abi.fixPointer(raw->signature));
+        methodRecord.impl = fixed(raw->impl);
+      }
+      visitor.onMethod(methodRecord);
+    }
+  }
+}
+
+void Walker::properties(uintptr_t owner, uintptr_t listAddress, bool isClass) {
+  if (!listAddress) {
+    return;
+  }
+
+  LIST(listAddress, umbrella::objc::property_list_t) {
+    const size_t baseAddress = stream.pos();
+
+    propertyRecord.owner = owner;
+    propertyRecord.classProperty = isClass;
+    for (size_t i = 0; i < list->count; i++) {
+      const uintptr_t address = baseAddress + i * sizeof(property_t);
+      const auto raw = stream.peek<umbrella::objc::property_t>(address);
+      if (!raw) {
+        break;
+      }
+
+      propertyRecord.address = address;
+      string(propertyRecord.name, abi.fixPointer(raw->name));
+      string(propertyRecord.attributes, abi.fixPointer(raw->attributes));
+      visitor.onProperty(propertyRecord);
+    }
+  }
+}
+
+void Walker::conformances(uintptr_t owner, uintptr_t listAddress) {
+  if (!listAddress) {
+    return;
+  }
+
+  LIST(listAddress, umbrella::objc::protocol_list_t) {
+    const size_t baseAddress = stream.pos();
+
+    conformanceRecord.owner = owner;
+    for (size_t i = 0; i < list->count; i++) {
+      const auto ptr = stream.peek<uintptr_t>(baseAddress + i * sizeof(uintptr_t));
+      if (!ptr) {
+        break;
+      }
+
+      conformanceRecord.protocol = abi.fixPointer(*ptr);
+      conformanceRecord.name.clear();
+      if (auto raw = stream.peek<umbrella::objc::protocol_t>(conformanceRecord.protocol)) {
+        string(conformanceRecord.name, abi.fixPointer(raw->name));
+      }
+      visitor.onConformance(conformanceRecord);
+    }
+  }
+}
+
+void Walker::ivars(uintptr_t owner, uintptr_t listAddress) {
+  if (!listAddress) {
+    return;
+  }
+
+  LIST(listAddress, umbrella::objc::ivar_list_t) {
+    const size_t baseAddress = stream.pos();
+
+    ivarRecord.owner = owner;
+    for (size_t i = 0; i < list->count; i++) {
+      const uintptr_t address = baseAddress + i * sizeof(ivar_t);
+      const auto raw = stream.peek<umbrella::objc::ivar_t>(address);
+      if (!raw) {
+        break;
+      }
+
+      ivarRecord.address = address;
+      ivarRecord.alignment = raw->alignment;
+      ivarRecord.size = raw->size;
+      string(ivarRecord.name, abi.fixPointer(raw->name));
+      string(ivarRecord.typeName, abi.fixPointer(raw->type));
+
+      // Same heuristic as in IVar::parse
+      if (!ivarRecord.typeName.empty() && !ivarRecord.name.empty()) {
+        if (ivarRecord.typeName[0] == '_' || ivarRecord.name[0] == 'T' ||
+            ivarRecord.name.size() <= 2) {
+          std::swap(ivarRecord.name, ivarRecord.typeName);
+        }
+      }
+      visitor.onIVar(ivarRecord);
+    }
+  }
+}
+
+} // namespace
+
+void visit(const ABIBase::TargetBinary& _Binary,
+           std::shared_ptr<ABIBase::TargetBinaryStream> _Stream, Visitor& visitor) {
+  // The ABI is only used to fix pointers, none of its caches will be filled.
+  ABIObjectiveC abi(&_Binary, _Stream);
+  Walker walker(abi, visitor);
+  walker.classes();
+  walker.categories();
+  walker.protocols();
+}
+
+} // namespace objc
+} // namespace umbrella
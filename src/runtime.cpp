@@ -17,9 +17,57 @@
 
 #include "umbrella/runtime.h"
 
+#include "ImageStream.h"
+
 namespace umbrella {
 
+namespace {
+
+/// The cursor bound to the current thread (see ABIBase::ScopedCursor).
+thread_local const ABIBase* BoundOwner = nullptr;
+thread_local ABIBase::TargetBinaryStream* BoundStream = nullptr;
+
+} // namespace
+
+ABIBase::ABIBase(std::shared_ptr<const TargetBinary> _Binary,
+                 std::shared_ptr<TargetBinaryStream> _Stream)
+    : Binary{std::move(_Binary)}, ImageBase{0}, Stream{std::move(_Stream)} {
+  if (Binary) {
+    ImageBase = Binary->imagebase();
+  } else if (auto imageStream = dynamic_cast<const ImageStream*>(Stream.get())) {
+    ImageBase = imageStream->imagebase();
+  }
+}
+
 ABIBase::ABIBase(const TargetBinary* _Binary, std::shared_ptr<TargetBinaryStream> _Stream)
-    : Binary{_Binary}, ImageBase{_Binary->imagebase()}, Stream{std::move(_Stream)} {}
+    // aliasing constructor: refers to the binary without owning it
+    : ABIBase(std::shared_ptr<const TargetBinary>(std::shared_ptr<const TargetBinary>(), _Binary),
+              std::move(_Stream)) {}
+
+ABIBase::TargetBinaryStream& ABIBase::stream() {
+  if (BoundOwner == this) {
+    return *BoundStream;
+  }
+  return *Stream;
+}
+
+std::shared_ptr<ABIBase::TargetBinaryStream> ABIBase::fork() const {
+  if (auto imageStream = dynamic_cast<const ImageStream*>(Stream.get())) {
+    return imageStream->clone();
+  }
+  return nullptr;
+}
+
+ABIBase::ScopedCursor::ScopedCursor(const ABIBase& _ABI,
+                                    std::shared_ptr<TargetBinaryStream> _Cursor)
+    : PrevOwner{BoundOwner}, PrevStream{BoundStream}, Cursor{std::move(_Cursor)} {
+  BoundOwner = &_ABI;
+  BoundStream = Cursor.get();
+}
+
+ABIBase::ScopedCursor::~ScopedCursor() {
+  BoundOwner = PrevOwner;
+  BoundStream = PrevStream;
+}
 
 } // namespace umbrella